@@ -17,9 +17,7 @@ void AppJobs::play(CybrEdit& cybrEdit) {
     newEdit.getTransport().play(false);
     
     add(newCybrEdit);
-    Timer::callAfterDelay((int)ceil(newEdit.getLength() * 1000.), [this, newCybrEdit]() {
-        remove(newCybrEdit);
-    });
+    removeAtPosition(newCybrEdit, newEdit.getLength(), false);
 }
 
 void AppJobs::record(CybrEdit& cybrEdit) {
@@ -28,6 +26,11 @@ void AppJobs::record(CybrEdit& cybrEdit) {
 
     newEdit.getTransport().triggerClearDevicesOnStop(); // Without this, we go into an infinite loop
     newCybrEdit->saveOnClose = true;
+    // Stream recorded events to disk instead of memory. The journal sits next
+    // to the edit that will be saved when recording finishes. Each take gets
+    // its own file, so a journal left by a crashed take is never mixed into
+    // this one. Those are recovered with --recover-journal.
+    newCybrEdit->enableJournal(File::getCurrentWorkingDirectory().getNonexistentChildFile("out", ".cybrjournal", false));
 
     // It is possible to record without any tracks armed, but that means that
     // the `OscInputDeviceInstance::prepareToRecord` and `startRecording` handlers
@@ -71,10 +74,48 @@ void AppJobs::record(CybrEdit& cybrEdit) {
     newCybrEdit->getEdit().getTransport().record(false, false);
 
     add(newCybrEdit);
-    Timer::callAfterDelay((int)ceil(newEdit.getLength() * 1000. + 1000), [this, newCybrEdit]() {
-        newCybrEdit->getEdit().getTransport().stop(true, false);
-        remove(newCybrEdit);
-    });
+    // Keep recording for a second after the end, so late events are captured
+    removeAtPosition(newCybrEdit, newEdit.getLength() + 1.0, true);
+}
+
+void AppJobs::removeAtPosition(CybrEdit* cybrEdit, double endTime, bool stopTransport) {
+    // We used to wait for the length of the edit on a wall clock timer. Polling
+    // the transport instead means that jobs finish as soon as playback gets to
+    // the end, even when the audio device runs faster than realtime.
+    positionJobs.add({ cybrEdit, endTime, stopTransport, -1.0, Time::getMillisecondCounterHiRes() });
+    if (!isTimerRunning()) startTimer(20);
+}
+
+void AppJobs::timerCallback() {
+    const double nowMs = Time::getMillisecondCounterHiRes();
+    for (int i = positionJobs.size(); --i >= 0;) {
+        auto& job = positionJobs.getReference(i);
+        if (!playingEdits.contains(job.cybrEdit)) {
+            positionJobs.remove(i);
+            continue;
+        }
+
+        auto& transport = job.cybrEdit->getEdit().getTransport();
+        const double position = transport.getCurrentPosition();
+        if (position != job.lastPosition) {
+            job.lastPosition = position;
+            job.lastMovedMs = nowMs;
+        } else if (nowMs - job.lastMovedMs > 5000) {
+            std::cerr
+                << "The transport has not moved for 5 seconds. Is there an audio device?"
+                << " (Try --headless)" << std::endl;
+            job.endTime = position; // give up, and finish the job below
+        }
+
+        if (position >= job.endTime) {
+            CybrEdit* cybrEdit = job.cybrEdit;
+            bool stopTransport = job.stopTransport;
+            positionJobs.remove(i);
+            if (stopTransport) transport.stop(true, false);
+            remove(cybrEdit);
+        }
+    }
+    if (positionJobs.isEmpty()) stopTimer();
 }
 
 bool AppJobs::add(CybrEdit* cybrEdit) {
@@ -98,3 +139,14 @@ void AppJobs::setRunForever(bool newFlag) {
     runForever = newFlag;
     if (changed) sendChangeMessage();
 }
+
+void AppJobs::beginTask() {
+    pendingTasks++;
+    sendChangeMessage();
+}
+
+void AppJobs::endTask() {
+    jassert(pendingTasks > 0);
+    pendingTasks = jmax(0, pendingTasks - 1);
+    sendChangeMessage();
+}
@@ -16,7 +16,7 @@
 #include "FluidOscServer.h"
 
 namespace te = tracktion_engine;
-class AppJobs : public juce::ChangeBroadcaster {
+class AppJobs : public juce::ChangeBroadcaster, private Timer {
 public:
     /** Play the edit. This creates a NEW CybrEdit and a new te::Edit */
     void play(CybrEdit& cybrEdit);
@@ -30,12 +30,33 @@ public:
     bool remove(const CybrEdit* cybrEdit);
 
     bool isEmpty() { return playingEdits.size() == 0; }
-    bool isFinished() { return isEmpty() && ! runForever; }
+    bool isFinished() { return isEmpty() && pendingTasks == 0 && ! runForever; }
     bool getRunForever() { return runForever; }
     void setRunForever(bool newFlag);
 
+    /** Jobs that are not a playing edit (like an OSC load test) should call
+     beginTask when they start, and endTask when they are done, so that the app
+     waits for them before quitting. Call these on the message thread. */
+    void beginTask();
+    void endTask();
+
     FluidOscServer fluidOscServer;
 private:
+    /** Remove cybrEdit when its transport reaches endTime. If stopTransport is
+     true, stop it first (which is how recordings get finished). */
+    void removeAtPosition(CybrEdit* cybrEdit, double endTime, bool stopTransport);
+    void timerCallback() override;
+
+    struct PositionJob {
+        CybrEdit* cybrEdit;
+        double endTime;
+        bool stopTransport;
+        double lastPosition;
+        double lastMovedMs;
+    };
+    Array<PositionJob> positionJobs;
+
     juce::OwnedArray<CybrEdit> playingEdits;
     bool runForever = false;
+    int pendingTasks = 0;
 };
@@ -23,7 +23,10 @@ void CLIApp::unhandledException(const std::exception*, const String&, int)
 
 void CLIApp::initialise(const String& commandLine) 
 {
+    RealtimeLog::getInstance().start();
+    CybrLog::getInstance().start();
     engine.getPluginManager().createBuiltInType<OpenFrameworksPlugin>();
+    engine.getPluginManager().createBuiltInType<LoudnessTapPlugin>();
     appJobs.addChangeListener(this);
     MessageManager::getInstance()->callAsync([this] { onRunning(); });
 }
@@ -40,6 +43,8 @@ void CLIApp::shutdown()
     // needed; the Project Manager settings will be saved anyway. I'm not %100
     // sure that this is the right way to do it, but for now I'm leaving it in.
     te::getApplicationSettings()->dispatchPendingMessages();
+    RealtimeLog::getInstance().stop();
+    CybrLog::getInstance().stop();
 
     std::cout << "Shutdown!" << std::endl << std::endl;
 }
@@ -64,18 +69,43 @@ void CLIApp::onRunning()
         "-f|--fluid-server",
         "-f|--fluid-server",
         "Launch a server and listen for fluid engine OSC messages",
-        "This runs a server that listens for OSC messages",
+        "This runs a server that listens for OSC messages. If there is an active\n\
+        edit, the server hosts a copy of it called \"default\". One server can\n\
+        host many edits, each with its own transport and selection. Create them\n\
+        with /edit/create name [file], and switch between them with /edit/select.\n\
+        /edit/render [file.wav] renders the selected edit on a background thread.\n\
+        When several clients share the server, each should begin its bundles with\n\
+        /session/select id, so that clients have separate selections. It only\n\
+        applies to the rest of its bundle. The server also accepts OSC over TCP\n\
+        on the same port, SLIP encoded (OSC 1.1) or size prefixed (OSC 1.0), for\n\
+        bundles that are too large for UDP. To pipeline requests, set a reply\n\
+        target with /reply/port, and include /seq id in a\n\
+        bundle. After applying it, the server replies /ack id handlerMicros\n\
+        queueDepth. /stats replies with message, error and drop counts, and\n\
+        handler latency percentiles, for each address. /stats/push periodMs\n\
+        sends them periodically. While an edit plays, changes to its structure\n\
+        are held for 50ms, and the playback graph is rebuilt once. Change the\n\
+        window with /rebuild/window ms, or /rebuild/window bar.",
         [this](auto&) {
             if (!appJobs.fluidOscServer.connect(options.listenPort)) {
                 std::cout << "FluidOscServer: Falied to connect" << std::endl;
                 return false;
             }
             appJobs.setRunForever(true);
+            appJobs.fluidOscServer.setEngine(engine);
             std::cout << "FluidOscServer: Connected!" << std::endl;
+            if (appJobs.fluidOscServer.listenForStreams(options.listenPort))
+                std::cout << "FluidOscServer: Listening for TCP on port " << options.listenPort << std::endl;
+            else
+                std::cout << "FluidOscServer: Failed to listen for TCP on port " << options.listenPort << std::endl;
+            if (auto* ui = dynamic_cast<CliUiBehaviour*>(&engine.getUIBehaviour())) {
+                ui->onProgress = [this](const String& jobName, float progress) {
+                    appJobs.fluidOscServer.sendProgress(jobName, progress);
+                };
+            }
             if (cybrEdit) {
                 CybrEdit* newCybrEdit = copyCybrEditForPlayback(*cybrEdit);
-                appJobs.fluidOscServer.activeCybrEdit.reset(newCybrEdit);
-                std::cout << "FluidOscServer: Activated new cybr edit" << std::endl;
+                appJobs.fluidOscServer.addEdit("default", newCybrEdit);
             }
             return true;
         } });
@@ -191,6 +221,47 @@ void CLIApp::onRunning()
             if (cybrEdit) cybrEdit->saveActiveEdit(outputFile);
         }});
 
+    cApp.addCommand({
+        "--recover-journal",
+        "--recover-journal=file.cybrjournal",
+        "Add the events from an unfinished recording's journal to the active edit",
+        "When a -r recording does not finish, its events stay in a .cybrjournal\n\
+        file next to where the edit would have been saved. New recordings never\n\
+        reuse such a file. To recover it, load the edit it was recorded against,\n\
+        then save: -i take.tracktionedit --recover-journal=out.cybrjournal -o\n\
+        take.tracktionedit. The journal is deleted once its events are saved.",
+        [this](const ArgumentList& args) {
+            String filename = args.getValueForOption("--recover-journal");
+            if (filename.isEmpty()) {
+                std::cerr << "--recover-journal requires a .cybrjournal file" << std::endl;
+                return;
+            }
+            if (!cybrEdit) {
+                std::cerr << "Failed to recover journal, because there is no active edit." << std::endl;
+                return;
+            }
+            cybrEdit->enableJournal(File::getCurrentWorkingDirectory().getChildFile(filename), true);
+        } });
+
+    cApp.addCommand({
+        "--inspect",
+        "--inspect=file.tracktionedit|directory",
+        "Quickly summarize edit files without loading them",
+        "Reads .tracktionedit XML directly, without creating an Edit, so it is much\n\
+        faster than -i followed by --list-tracks or --list-clips. Given a directory,\n\
+        every .tracktionedit file inside it (recursively) is inspected in parallel.\n\
+        Prints one line of JSON per file with its tracks, clips, plugins, note\n\
+        counts and audio sources. Binary edit files are reported as errors.",
+        [](const ArgumentList& args) {
+            String path = args.getValueForOption("--inspect");
+            if (path.isEmpty()) {
+                std::cerr << "--inspect requires a file or directory" << std::endl;
+                return;
+            }
+            EditInspector::inspectAll(File::getCurrentWorkingDirectory().getChildFile(path),
+                                      SystemStats::getNumCpus());
+        } });
+
     cApp.addCommand({
         "--list-clips",
         "--list-clips",
@@ -244,6 +315,66 @@ void CLIApp::onRunning()
             std::cout << "Edit Length: " << cybrEdit->getEdit().getLength() << " seconds" << std::endl << std::endl;
         } });
 
+    cApp.addCommand({
+        "--analyze",
+        "--analyze[=report.json]",
+        "Measure loudness and peaks of each track and the master mix",
+        "Renders the active edit once, without writing audio, and measures every\n\
+        audio track (after its volume and pan) and the master mix. For each, the\n\
+        report includes integrated loudness (LUFS, per ITU-R BS.1770), true peak\n\
+        and sample peak (dBFS), RMS (dBFS), and the number of clipped samples.\n\
+        The JSON report is printed, and also saved if a filename is given.\n\
+        Values that are silent (-inf) are written as null.",
+        [this](const ArgumentList& args) {
+            if (!cybrEdit) {
+                std::cerr << "Failed to analyze, because there is no active edit." << std::endl;
+                return;
+            }
+            EditAnalysis analysis(cybrEdit->getEdit());
+            if (!analysis.prepare()) return;
+            analysis.run();
+            String json = JSON::toString(analysis.getReport());
+            std::cout << json << std::endl;
+
+            String filename = args.getValueForOption("--analyze");
+            if (filename.isNotEmpty()) {
+                File file = File::getCurrentWorkingDirectory().getChildFile(filename);
+                if (file.replaceWithText(json)) std::cout << "Saved analysis: " << file.getFullPathName() << std::endl;
+                else std::cerr << "Failed to save analysis: " << file.getFullPathName() << std::endl;
+            }
+        } });
+
+    cApp.addCommand({
+        "--batch",
+        "--batch=manifest.json",
+        "Save, render and analyze many edits in one process",
+        "Much faster than running cybr once per edit, because the engine, the\n\
+        plugin list, plugin binaries and audio file readers are loaded once and\n\
+        shared by every edit. Edits are loaded on the message thread, and rendered\n\
+        on a pool of threads. Prints one line of JSON per job as it finishes. Paths\n\
+        in the manifest are relative to the manifest file. See EditBatch.h. Example:\n\
+        {\"threads\": 4, \"jobs\": [{\"input\": \"a.tracktionedit\",\n\
+         \"render\": \"out/a.wav\", \"analyze\": \"out/a.json\", \"save\": \"out/a.tracktionedit\"}]}",
+        [this](const ArgumentList& args) {
+            if (editBatch) {
+                std::cerr << "There is already a batch running" << std::endl;
+                return;
+            }
+            EditBatch::Manifest manifest;
+            auto file = File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--batch"));
+            auto result = EditBatch::Manifest::fromFile(file, manifest);
+            if (result.failed()) {
+                std::cerr << "Invalid --batch manifest: " << result.getErrorMessage() << std::endl;
+                return;
+            }
+            editBatch = std::make_unique<EditBatch>(engine, manifest);
+            editBatch->onFinished = [this] { appJobs.endTask(); };
+            // begin first, because a batch where every job fails finishes
+            // inside start()
+            appJobs.beginTask();
+            editBatch->start();
+        } });
+
     cApp.addCommand({
         "--print-config-filename",
         "--print-config-filename",
@@ -253,6 +384,47 @@ void CLIApp::onRunning()
             std::cout << te::getApplicationSettings()->getFile().getFullPathName() << std::endl;
         } });
 
+    cApp.addCommand({
+        "--headless",
+        "--headless[=speed]",
+        "Play and record with a virtual audio device instead of a sound card",
+        "Use an audio device that needs no hardware. Output is discarded, and input\n\
+        is silent. By default it runs as fast as possible. Give a speed to run at a\n\
+        multiple of realtime instead: --headless=1 for realtime, --headless=4 for\n\
+        four times faster. Jobs like -p and -r finish when the transport reaches\n\
+        the end of the edit, so they take as long as the speed allows. Specify this\n\
+        before -p or -r. NOTE: OSC recorded with -r is timed against the wall\n\
+        clock, so only record OSC at --headless=1.",
+        [this](const ArgumentList& args) {
+            String speedString = args.getValueForOption("--headless");
+            double speed = speedString.isEmpty() ? 0.0 : speedString.getDoubleValue();
+            auto& audioDeviceManager = engine.getDeviceManager().deviceManager;
+            // --headless may be given more than once. Register the type once,
+            // and reopen its device if it is already running, so that it picks
+            // up the new speed.
+            HeadlessAudioIODeviceType* headlessType = nullptr;
+            for (auto* type : audioDeviceManager.getAvailableDeviceTypes())
+                if (auto* t = dynamic_cast<HeadlessAudioIODeviceType*>(type)) headlessType = t;
+            if (headlessType) {
+                headlessType->setSpeed(speed);
+            } else {
+                audioDeviceManager.addAudioDeviceType(new HeadlessAudioIODeviceType(speed));
+            }
+            if (audioDeviceManager.getCurrentAudioDeviceType() == HeadlessAudioIODeviceType::typeName) {
+                audioDeviceManager.closeAudioDevice();
+                audioDeviceManager.restartLastAudioDevice();
+            } else {
+                audioDeviceManager.setCurrentAudioDeviceType(HeadlessAudioIODeviceType::typeName, true);
+            }
+            if (auto* device = audioDeviceManager.getCurrentAudioDevice()) {
+                std::cout << "Using audio device: " << device->getName();
+                if (speed > 0) std::cout << " at " << speed << "x realtime" << std::endl;
+                else std::cout << " as fast as possible" << std::endl;
+            } else {
+                std::cerr << "Failed to open the headless audio device" << std::endl;
+            }
+        } });
+
     cApp.addCommand({
         "-p",
         "-p",
@@ -270,13 +442,19 @@ void CLIApp::onRunning()
         "-r",
         "-r",
         "Record OSC while playing the Edit. WORK-IN-PROGRESS",
-        "Undocumented! TODO: doc",
+        "Listens for OSC on the listen port while playing the active edit. The\n\
+        OSC input device targets the CYBR_HOST track. Incoming /note, /noteoff\n\
+        and /cc messages are converted to MIDI, and played live on that track\n\
+        (pitch velocity [channel], pitch [channel], and cc value [channel]).\n\
+        When recording stops, the MIDI is in a clip on the CYBR_HOST track, and\n\
+        integer values (such as /test 64) are on the automation curve of the\n\
+        parameter set with --record-param. The CYBRTRACK sidecar is also kept.",
         [this](auto&) {
              // Creating an OscInputDevice indirectly creates an OscInputDeviceInstance
              // if one is needed. Where does the input device instance get instantiated?
              // It happens from the `TransportControl::ensureContextAllocated` method,
              // which is called whenever we play the edit.
-            auto result = createOscInputDevice(engine, OscInputDevice::name, options.listenPort);
+            auto result = createOscInputDevice(engine, OscInputDevice::name, options.listenPort, options.recordParamName);
             if (result.wasOk()){
                 std::cout << "Created OscInputDevice: SUCCESS!" << std::endl;
             } else {
@@ -336,6 +514,21 @@ void CLIApp::onRunning()
             if (cybrEdit) cybrEdit->listState();
         } });
 
+    cApp.addCommand({
+        "--log",
+        "--log=warn,server:debug",
+        "Set which log messages are printed",
+        "Each message has a level (trace, debug, info, warn or error) and a\n\
+        category (general, edit, plugin, device or server). Messages below the\n\
+        level of their category are skipped without being formatted. A bare level\n\
+        sets every category. Use off to silence a category. Valid only for\n\
+        subsequent args. Default=info. The output of commands like --list-plugins\n\
+        is not log output, so it is always printed.",
+        [](const ArgumentList& args) {
+            auto result = CybrLog::getInstance().configure(args.getValueForOption("--log"));
+            if (result.failed()) std::cerr << "Invalid --log: " << result.getErrorMessage() << std::endl;
+        } });
+
     cApp.addCommand({
         "--target-port",
         "--target-port=9999",
@@ -369,6 +562,19 @@ void CLIApp::onRunning()
             }
         } });
 
+    cApp.addCommand({
+        "--record-param",
+        "--record-param=volume",
+        "Set the parameter that -r records OSC values to",
+        "When recording with -r, integer OSC values (0-127) are written to the\n\
+        automation curve of a parameter on the CYBR_HOST track. Specify the\n\
+        parameter name or ID. Valid only for subsequent args. Default=volume",
+        [this](const ArgumentList& args) {
+            String paramName = args.getValueForOption("--record-param");
+            options.recordParamName = paramName;
+            std::cout << "Record parameter set to: " << paramName << std::endl;
+        } });
+
     cApp.addCommand({
         "--ping-osc",
         "--ping-osc[=100]",
@@ -378,9 +584,9 @@ void CLIApp::onRunning()
         You may optionally specify a period in milliseconds. For example, to send\n\
         every 500 milliseconds, you would specify --ping-osc=500. This uses a\n\
         dedicated thread and a High Resolution Timer, and unlike sending from Max or\n\
-        node.js it can send with quite high frequency, and quite low jitter. In a\n\
-        cursory test it was sending every 1ms with with ~0.1ms jitter (as measured on\n\
-        receieving end). The test was on a 2015 MacbookPro. Default=100",
+        node.js it can send with quite high frequency, and quite low jitter. To\n\
+        measure the latency and jitter on your machine, use --bench-osc.\n\
+        Default=100",
         [this](const ArgumentList& args) {
             if (oscSource) { 
                 std::cout << "There is already an oscSource. Cannot start a seconds one" << std::endl;
@@ -392,6 +598,66 @@ void CLIApp::onRunning()
                                                     period > 0 ? period : 100);
             appJobs.setRunForever(true);
         } });
+
+    cApp.addCommand({
+        "--bench-osc",
+        "--bench-osc[=10,5,2,1]",
+        "Measure OSC latency and jitter at several send periods",
+        "Sends timestamped /test messages (like --ping-osc) to a receiver in the\n\
+        same process, on the loopback interface and the listen port. Each period\n\
+        (in milliseconds) is measured for 5 seconds. After each one, a single line\n\
+        of JSON is printed with the p50, p99, p99.9 and max of the latency, and of\n\
+        the jitter (how far each inter-arrival interval is from the period).\n\
+        Lines that start with '{' are results, so the output is easy to filter.",
+        [this](const ArgumentList& args) {
+            if (oscBenchmark) {
+                std::cerr << "There is already an OSC benchmark running" << std::endl;
+                return;
+            }
+            Array<int> periods;
+            for (auto& p : StringArray::fromTokens(args.getValueForOption("--bench-osc"), ",", ""))
+                if (p.getIntValue() > 0) periods.add(p.getIntValue());
+            if (periods.isEmpty()) periods = { 10, 5, 2, 1 };
+
+            oscBenchmark = std::make_unique<OscBenchmark>(options.listenPort, periods);
+            oscBenchmark->onFinished = [this] { appJobs.endTask(); };
+            if (oscBenchmark->start()) appJobs.beginTask();
+            else oscBenchmark = nullptr;
+        } });
+
+    cApp.addCommand({
+        "--osc-load",
+        "--osc-load[=scenario.json]",
+        "Stress an OSC server with a mix of messages from many threads",
+        "Sends a weighted mix of OSC addresses and arguments to --target-host and\n\
+        --target-port, with steady and burst rates, optional bundles, and one or\n\
+        more sender threads. The achieved send rate is printed every second. When\n\
+        the test ends, /load/report is sent with the number of messages sent, and\n\
+        a FluidOscServer (-f) prints how many it received and dropped. Without a\n\
+        scenario file, send 1000 /load/test messages per second for 10 seconds.\n\
+        See OscLoadGenerator.h for the scenario format. Example:\n\
+        {\"threads\": 2, \"rate\": 5000, \"bundleSize\": 4,\n\
+         \"burst\": {\"rate\": 50000, \"length\": 0.25, \"every\": 2},\n\
+         \"messages\": [{\"address\": \"/load/note\", \"args\": [\"i\", \"i\"]}]}",
+        [this](const ArgumentList& args) {
+            if (oscLoadGenerator) {
+                std::cerr << "There is already an OSC load test running" << std::endl;
+                return;
+            }
+            OscLoadGenerator::Scenario scenario = OscLoadGenerator::Scenario::fromVar({});
+            String filename = args.getValueForOption("--osc-load");
+            if (filename.isNotEmpty()) {
+                auto result = OscLoadGenerator::Scenario::fromFile(File::getCurrentWorkingDirectory().getChildFile(filename), scenario);
+                if (result.failed()) {
+                    std::cerr << "Invalid --osc-load scenario: " << result.getErrorMessage() << std::endl;
+                    return;
+                }
+            }
+            oscLoadGenerator = std::make_unique<OscLoadGenerator>(options.targetHostname, options.targetPort, scenario);
+            oscLoadGenerator->onFinished = [this] { appJobs.endTask(); };
+            if (oscLoadGenerator->start()) appJobs.beginTask();
+            else oscLoadGenerator = nullptr;
+        } });
     
     cApp.addCommand({
         "--jack-test",
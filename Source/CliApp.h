@@ -15,9 +15,16 @@
 #include "CliUiBehaviour.h"
 #include "AppJobs.h"
 #include "OscSource.h"
+#include "OscLoadGenerator.h"
+#include "OscBenchmark.h"
+#include "EditAnalysis.h"
+#include "EditBatch.h"
+#include "HeadlessAudioDevice.h"
+#include "EditInspector.h"
 #include "CybrEdit.h"
 #include "OscInputDevice.h"
 #include "FluidOscServer.h"
+#include "RealtimeLog.h"
 
 class CybrProps : public te::PropertyStorage {
 public:
@@ -119,6 +126,7 @@ private:
         int targetPort { 9999 };
         String targetHostname { "127.0.0.1" };
         int listenPort { 9999 };
+        String recordParamName { "volume" };
 
         /** When helpModeFlag is enabled, the app should print the detailed command
          string instead of running the command. CLI users may set the helpModeFlag
@@ -132,6 +140,9 @@ private:
     // cybrEdit is a wrapper around edit.
     std::unique_ptr<CybrEdit> cybrEdit;
     std::unique_ptr<OscSource> oscSource;
+    std::unique_ptr<OscLoadGenerator> oscLoadGenerator;
+    std::unique_ptr<OscBenchmark> oscBenchmark;
+    std::unique_ptr<EditBatch> editBatch;
 
     // onRunning should be called once, and only after the MessageManager is
     // also running. There is where I am putting the body of the application.
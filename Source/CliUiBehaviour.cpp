@@ -11,14 +11,84 @@
 #include "CliUiBehaviour.h"
 
 void CliUiBehaviour::runTaskWithProgressBar(te::ThreadPoolJobWithProgress& job) {
-    
-    while (job.runJob() != juce::ThreadPoolJob::JobStatus::jobHasFinished) {
-        std::cout << "\rprogress: " << job.getCurrentTaskProgress() << "                     ";
+    Progress progress;
+
+    // A job that is already running on a pool thread (ours or tracktion's)
+    // could deadlock waiting for a free thread, so run nested jobs inline.
+    if (ThreadPoolJob::getCurrentThreadPoolJob() != nullptr) {
+        while (job.runJob() != juce::ThreadPoolJob::JobStatus::jobHasFinished)
+            reportProgress(job, progress, false);
+        reportProgress(job, progress, true);
+        std::cout << std::endl;
+        return;
+    }
+
+    // Even on the message thread we just block. Dispatching messages while we
+    // wait would let OSC handlers and timers run in the middle of whichever
+    // handler started this job, and they could delete the edit it is using.
+    pool.addJob(&job, false);
+    while (pool.contains(&job)) {
+        pool.waitForJobToFinish(&job, progressIntervalMs);
+        reportProgress(job, progress, false);
     }
-    DBG(job.getCurrentTaskProgress());
+    reportProgress(job, progress, true);
     std::cout << std::endl;
 }
 
+void CliUiBehaviour::runTaskAsync(te::ThreadPoolJobWithProgress& job, std::function<void()> onComplete) {
+    jassert(MessageManager::getInstance()->isThisTheMessageThread());
+    asyncTasks.add(new AsyncTask{ &job, std::move(onComplete), {} });
+    pool.addJob(&job, false);
+    if (!isTimerRunning()) startTimer(progressIntervalMs);
+}
+
+void CliUiBehaviour::cancelTask(te::ThreadPoolJobWithProgress& job) {
+    pool.removeJob(&job, true, -1);
+    for (int i = asyncTasks.size(); --i >= 0;)
+        if (asyncTasks[i]->job == &job) asyncTasks.remove(i);
+    if (asyncTasks.isEmpty()) stopTimer();
+}
+
+void CliUiBehaviour::timerCallback() {
+    // Take finished tasks out of the list before calling them back, because
+    // a callback may start or cancel another task.
+    OwnedArray<AsyncTask> finished;
+    for (int i = asyncTasks.size(); --i >= 0;) {
+        auto* task = asyncTasks[i];
+        if (pool.contains(task->job)) {
+            reportProgress(*task->job, task->progress, false);
+            continue;
+        }
+        reportProgress(*task->job, task->progress, true);
+        finished.insert(0, asyncTasks.removeAndReturn(i));
+    }
+    if (asyncTasks.isEmpty()) stopTimer();
+
+    if (!finished.isEmpty()) std::cout << std::endl;
+    for (auto* task : finished)
+        if (task->onComplete) task->onComplete();
+}
+
+void CliUiBehaviour::reportProgress(te::ThreadPoolJobWithProgress& job, Progress& state, bool force) {
+    // Writing to stdout on every iteration of the job used to take more time
+    // than the job itself, so only report changes, and not too often.
+    const double nowMs = Time::getMillisecondCounterHiRes();
+    const float progress = job.getCurrentTaskProgress();
+    if (!force && (nowMs - state.lastMs < progressIntervalMs || progress == state.last)) return;
+    state.lastMs = nowMs;
+    state.last = progress;
+
+    std::cout << "\rprogress: " << roundToInt(progress * 100.f) << "%    " << std::flush;
+
+    if (!onProgress) return;
+    const String name = job.getJobName();
+    if (MessageManager::getInstance()->isThisTheMessageThread()) {
+        onProgress(name, progress);
+    } else {
+        MessageManager::callAsync([this, name, progress] { if (onProgress) onProgress(name, progress); });
+    }
+}
+
   void CliUiBehaviour::showWarningAlert(const juce::String & title, const juce::String & message)
   {
       std::cout << "Warn Alert: " << title << " --- " << message << std::endl;
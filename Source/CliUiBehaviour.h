@@ -13,9 +13,36 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 namespace te = tracktion_engine;
 
-class CliUiBehaviour : public te::UIBehaviour {
+class CliUiBehaviour : public te::UIBehaviour, private Timer {
+public:
+    /** Tracktion calls this for long operations (rendering, freezing, proxy
+     generation). It must not return until the job has finished, because the
+     caller owns the job and reads its result straight afterwards. The job runs
+     on a background thread pool, and the calling thread blocks until it is
+     done. Messages are not dispatched while we wait, even on the message
+     thread, so handlers are never re-entered. Code that runs on the message
+     thread while other work is going on (like the server) should use
+     runTaskAsync instead. Progress is reported at most every
+     progressIntervalMs. */
     virtual void runTaskWithProgressBar(te::ThreadPoolJobWithProgress&);
 
+    /** Start a job on the background pool and return straight away. Call this
+     on the message thread. Progress is reported like runTaskWithProgressBar,
+     and onComplete is called on the message thread once the job has finished.
+     The job must stay alive until then, or until cancelTask returns. */
+    void runTaskAsync(te::ThreadPoolJobWithProgress& job, std::function<void()> onComplete);
+
+    /** Stop a job started with runTaskAsync, and wait for it to exit. Its
+     onComplete is not called. Call this on the message thread. */
+    void cancelTask(te::ThreadPoolJobWithProgress& job);
+
+    /** If set, this is called on the message thread with the job name and its
+     progress (0 to 1), at the same throttled rate that progress is printed. In
+     server mode, this lets FluidOscServer send progress to clients. */
+    std::function<void(const String& jobName, float progress)> onProgress;
+
+    int progressIntervalMs = 100;
+
     /** Should display a dismissable alert window. N.B. this should be non-blocking. */
     virtual void showWarningAlert(const juce::String& title, const juce::String& message);
 
@@ -41,4 +68,25 @@ class CliUiBehaviour : public te::UIBehaviour {
 
     /** Should display a temporary warning message. */
     virtual void showWarningMessage(const juce::String& message);
+
+private:
+    /** What was last reported for one job. Jobs can run at the same time, so
+     each one has its own. */
+    struct Progress {
+        double lastMs = 0;
+        float last = -1;
+    };
+
+    struct AsyncTask {
+        te::ThreadPoolJobWithProgress* job;
+        std::function<void()> onComplete;
+        Progress progress;
+    };
+
+    void timerCallback() override;
+    void reportProgress(te::ThreadPoolJobWithProgress& job, Progress& state, bool force);
+
+    /** Declared first, so it is deleted last, after the pool has stopped */
+    OwnedArray<AsyncTask> asyncTasks;
+    ThreadPool pool { 2 };
 };
@@ -15,38 +15,101 @@ CybrEdit::CybrEdit(te::Edit* e) :
     state(edit->state.getOrCreateChildWithName(CYBR, nullptr))
 {
     cybrTrackList = std::make_unique<CybrTrackList>(*this, state);
-    std::cout << "CYBR sidecar to: " << edit->editFileRetriever().getFullPathName() << std::endl;
-
-    // Inside the timer callback is where messages are collected from the input
-    // device instances, and applied to the edit's ValueTree. The juce::Timer
-    // docs say that interval accuracy should be about 10-20 millisecond, which
-    // informed my on the interval. However this may be worth tweaking, depending
-    // on the volume of incoming messages.
-    startTimer(15);
+    CYBR_LOG(edit, info, "CYBR sidecar to: " << edit->editFileRetriever().getFullPathName());
+
+    // Messages are collected from the input device instances, and applied to
+    // the edit's ValueTree when an instance tells us that it has new data (see
+    // oscInputDataReady). When nothing is being recorded, we never wake up.
+    OscInputDeviceInstance::addInstanceListener(this);
+    // The edit may already have instances, so attach to them now
+    triggerAsyncUpdate();
 }
 
 CybrEdit::~CybrEdit() {
+    OscInputDeviceInstance::removeInstanceListener(this);
+    cancelPendingUpdate();
     flushPendingChanges();
+    for (auto* oscInput : getOscInputs()) oscInput->setDataListener(nullptr);
+
     if (saveOnClose)
         saveActiveEdit(File::getCurrentWorkingDirectory().getChildFile({ "out.tracktionedit" }));
+
+    // If we saved, the journal is empty, and can be removed. If not, keep it,
+    // so that the events may be recovered later.
+    if (journal) {
+        // Events from the last few ms may still be queued. They have to be in
+        // the file before we decide if it is empty.
+        journal->flush();
+        File journalFile = journal->getFile();
+        bool isEmpty = journal->getNumRecords() == 0;
+        journal = nullptr;
+        if (isEmpty) journalFile.deleteFile();
+    }
+}
+
+void CybrEdit::enableJournal(File journalFile, bool recover)
+{
+    journal = std::make_unique<CybrJournal>(journalFile, recover);
+    if (!journal->isOpen()) journal = nullptr;
+}
+
+void CybrEdit::handleAsyncUpdate()
+{
+    // Clear the flag before reading, so that data written while we are
+    // reading triggers another update.
+    wakeupPending = false;
+    flushPendingChanges();
+}
+
+void CybrEdit::oscInputInstancesChanged()
+{
+    // An instance may be half constructed or half deleted, so just forget
+    // the cached list, and rebuild it on the next update.
+    oscInputs.clearQuick();
+    oscInputsChanged = true;
+    triggerAsyncUpdate();
+}
+
+void CybrEdit::oscInputDataReady()
+{
+    // This is called from the audio thread on every block that has data. Only
+    // the first call after a flush posts a message to the message thread.
+    if (!wakeupPending.exchange(true)) triggerAsyncUpdate();
 }
 
-void CybrEdit::timerCallback()
+void CybrEdit::oscInputFlushRequested()
 {
+    wakeupPending = false;
     flushPendingChanges();
 }
 
+const Array<OscInputDeviceInstance*>& CybrEdit::getOscInputs()
+{
+    if (oscInputsChanged) {
+        oscInputsChanged = false;
+        oscInputs.clearQuick();
+        for (auto* instance : edit->getAllInputDevices()) {
+            if (auto* oscInput = dynamic_cast<OscInputDeviceInstance*>(instance)) {
+                oscInput->setDataListener(this);
+                oscInputs.add(oscInput);
+            }
+        }
+    }
+    return oscInputs;
+}
+
 void CybrEdit::flushPendingChanges()
 {
     // Read any received OSC messages
-    auto inputDeviceInstances = edit->getAllInputDevices();
-    for (auto* instance : inputDeviceInstances) {
-        if (auto* oscInput = dynamic_cast<OscInputDeviceInstance*>(instance)) {
-            auto* t = cybrTrackList->getOrCreateLastTrack();
-            for (auto& message : oscInput->toMessageThread.read()) {
-                t->addEvent(message.streamTime, message.value);
-            }
+    for (auto* oscInput : getOscInputs()) {
+        auto* t = cybrTrackList->getOrCreateLastTrack();
+        auto messages = oscInput->toMessageThread.read();
+        int trackIndex = cybrTrackList->getNumTracks() - 1;
+        for (auto& message : messages) {
+            if (!journal) t->addEvent(message.streamTime, message.value);
+            else if (t->claimEventTime(message.streamTime)) journal->append(trackIndex, message.streamTime, message.value);
         }
+        oscInput->recordPending(messages);
     }
 }
 
@@ -153,7 +216,8 @@ void CybrEdit::saveActiveEdit(File outputFile, bool useRelativePaths) {
     
     if (outputExt == ".tracktionedit") {
         // Save a .tracktionedit file.
-        std::cout << "Saving: " << outputFile.getFullPathName() << std::endl;
+        CYBR_LOG(edit, info, "Saving: " << outputFile.getFullPathName());
+        if (journal) journal->compactInto(*cybrTrackList);
         // When edit files are saved, prefer relative paths.
         edit->editFileRetriever = [outputFile] { return outputFile; };
         setClipSourcesToDirectFileReferences(*edit, useRelativePaths, true);
@@ -163,7 +227,7 @@ void CybrEdit::saveActiveEdit(File outputFile, bool useRelativePaths) {
     }
     else if (outputExt == ".wav")
     {
-        std::cout << "Save: " << outputFile.getFullPathName() << std::endl;
+        CYBR_LOG(edit, info, "Save: " << outputFile.getFullPathName());
         // Just add all the tracks to the bitmask
         BigInteger tracksToDo;
         {
@@ -179,10 +243,8 @@ void CybrEdit::saveActiveEdit(File outputFile, bool useRelativePaths) {
                                    tracksToDo, true, {}, false);
     }
     else {
-        std::cout
-        << "Could not save file due to unknown extension: "
-        << outputFile.getFullPathName()
-        << std::endl;
+        CYBR_LOG(edit, warn, "Could not save file due to unknown extension: "
+            << outputFile.getFullPathName());
     }
 }
 
@@ -198,7 +260,7 @@ te::AudioTrack* CybrEdit::getOrCreateCybrHostAudioTrack() {
         return true;
     });
     if (!found) {
-        std::cout << "No CYBR_HOST audio track found" << std::endl;
+        CYBR_LOG(edit, info, "No CYBR_HOST audio track found");
         // We just want to add a track, and don't really care where it is.
         // I'm using insertPoint creation from Edit::ensureNumberOfAudioTracks
         te::TrackInsertPoint insertPoint(nullptr, getTopLevelTracks (*edit).getLast());
@@ -15,6 +15,7 @@
 #include "OpenFrameworksPlugin.h"
 #include "CybrTrackList.h"
 #include "OscInputDeviceInstance.h"
+#include "CybrJournal.h"
 
 class CybrTrackList;
 namespace te = tracktion_engine;
@@ -27,7 +28,8 @@ const juce::Identifier CYBR("CYBR");
  */
 class CybrEdit :
     public ValueTree::Listener,
-    private Timer
+    private AsyncUpdater,
+    private OscInputDeviceInstance::Listener
 {
 private:
     std::unique_ptr<te::Edit> edit;
@@ -49,6 +51,13 @@ public:
     te::Edit& getEdit() { return *edit; }
     /** Ensure that all the most recent changes are applied to the state */
     void flushPendingChanges();
+
+    /** Write incoming CYBRTRACK events to an append-only journal file instead
+     of the ValueTree. The journal is compacted into the edit when it is saved,
+     and deleted when the CybrEdit is deleted. Use this for long recordings.
+     Set recover to pick up the events in a journal left behind by a session
+     that did not finish; they are added to this edit when it is saved. */
+    void enableJournal(File journalFile, bool recover = false);
 
     /** WIP - testing custom plugin */
     void junk();
@@ -63,9 +72,15 @@ public:
     void valueTreePropertyChanged(ValueTree &treeWhosePropertyHasChanged, const Identifier &property) override;
     void valueTreeChildAdded(juce::ValueTree &parentTree, juce::ValueTree &childWhichHasBeenAdded) override;
     
-    /** Check if the CybrEdit needs to be updated. This is where we retrieve incoming
-     OSC messages from the OscInputDeviceInstance. */
-    void timerCallback() override;
+    /** Called on the message thread after an OscInputDeviceInstance signals
+     that it has data for us. This is where we retrieve incoming OSC messages
+     from the OscInputDeviceInstance. */
+    void handleAsyncUpdate() override;
+
+    // OscInputDeviceInstance::Listener overrides
+    void oscInputInstancesChanged() override;
+    void oscInputDataReady() override;
+    void oscInputFlushRequested() override;
 
     // te::EditItem overrides
     String getName() { return {"Cybr Edit Sidecar"}; }
@@ -73,5 +88,17 @@ public:
     // CyberEdit Member variables
     ValueTree state; // type is CYBR. Immediate child of the main edit state
     std::unique_ptr<CybrTrackList> cybrTrackList;
+    std::unique_ptr<CybrJournal> journal;
     bool saveOnClose = false;
+
+private:
+    /** Get the OSC input instances in this edit. The list is cached, and only
+     rebuilt after instances have been created or deleted. */
+    const Array<OscInputDeviceInstance*>& getOscInputs();
+    Array<OscInputDeviceInstance*> oscInputs;
+    bool oscInputsChanged = true;
+
+    /** Set by the audio thread when it has data for us, cleared by the message
+     thread just before it reads the data. */
+    std::atomic<bool> wakeupPending { false };
 };
@@ -0,0 +1,177 @@
+/*
+  ==============================================================================
+
+    CybrJournal.cpp
+    Created: 18 Oct 2026 2:31:18pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "CybrJournal.h"
+#include "CybrTrackList.h"
+
+static const char journalMagic[8] = { 'C', 'Y', 'B', 'R', 'J', 'N', 'L', '1' };
+
+CybrJournal::CybrJournal(const File& f, bool recover) : Thread("Cybr Journal"), file(f)
+{
+    if (recover && !file.existsAsFile()) {
+        CYBR_LOG(edit, error, "Journal not found: " << file.getFullPathName());
+        return;
+    }
+    opened = open(recover);
+    if (!opened) {
+        CYBR_LOG(edit, error, "Failed to open journal: " << file.getFullPathName());
+        return;
+    }
+    if (numRecords > 0) {
+        CYBR_LOG(edit, info, "Recovered " << numRecords << " events from an earlier session in: "
+            << file.getFullPathName());
+    }
+    startThread();
+}
+
+CybrJournal::~CybrJournal()
+{
+    stopThread(2000);
+    flush();
+}
+
+void CybrJournal::append(int trackIndex, double time, int value)
+{
+    // The queue throws away old events when it is full, which a journal must
+    // never do. The message thread is the only writer, so once we have
+    // emptied the queue there is room for this event.
+    if (queue.getNumReady() >= queueSize - 1) flush();
+    queue.writeMessage({ time, (int32)value, (int32)trackIndex });
+    // Wake the writer before the queue gets close to full. Otherwise it will
+    // pick the events up on its next pass.
+    if (queue.getNumReady() > 4096) notify();
+}
+
+void CybrJournal::flush()
+{
+    // The map lock also makes sure that only one thread reads the queue
+    const ScopedLock sl (mapLock);
+    writePending();
+}
+
+void CybrJournal::compactInto(CybrTrackList& trackList)
+{
+    // The message thread is the only writer to the queue, so once it has been
+    // written to the file, nothing else can be added until we return.
+    const ScopedLock sl (mapLock);
+    writePending();
+    if (!map) return;
+    int64 count = numRecords;
+    Record* records = getRecords();
+    for (int64 i = 0; i < count; i++) {
+        const Record& r = records[i];
+        if (auto* track = trackList.getTrackOrLast(r.trackIndex))
+            track->appendEvent(r.time, r.value);
+    }
+
+    numRecords = 0;
+    getHeader()->numRecords = 0;
+    CYBR_LOG(edit, info, "Compacted " << count << " journaled events into the edit");
+    if (numDropped > 0)
+        CYBR_LOG(edit, error, "Journal could not write " << numDropped << " events. They are missing from the edit");
+}
+
+void CybrJournal::run()
+{
+    while (!threadShouldExit()) {
+        {
+            const ScopedLock sl (mapLock);
+            writePending();
+        }
+        wait(50);
+    }
+}
+
+void CybrJournal::writePending()
+{
+    auto pending = queue.read();
+    if (pending.empty()) return;
+    if (!map) {
+        numDropped += (int64)pending.size();
+        return;
+    }
+
+    int64 count = numRecords;
+    int64 needed = count + (int64)pending.size();
+    if (needed > getCapacity()) {
+        int64 numBytes = (int64)sizeof(Header) + needed * (int64)sizeof(Record);
+        numBytes = (numBytes / growthBytes + 1) * growthBytes;
+        if (!growTo(numBytes)) {
+            numDropped += (int64)pending.size();
+            CYBR_LOG(edit, error, "Failed to grow journal. Dropped " << pending.size() << " events");
+            return;
+        }
+    }
+
+    Record* records = getRecords();
+    for (auto& r : pending) records[count++] = r;
+
+    // Publish the new count only after the records are in place
+    std::atomic_thread_fence(std::memory_order_release);
+    getHeader()->numRecords = (uint64)count;
+    numRecords = count;
+}
+
+bool CybrJournal::open(bool recover)
+{
+    bool isNew = !file.existsAsFile() || file.getSize() < (int64)sizeof(Header);
+    if (isNew) {
+        file.deleteFile();
+        if (!file.create() || !growTo(growthBytes)) return false;
+        std::memcpy(getHeader()->magic, journalMagic, sizeof(journalMagic));
+        getHeader()->numRecords = 0;
+        return true;
+    }
+
+    map = std::make_unique<MemoryMappedFile>(file, MemoryMappedFile::readWrite);
+    if (map->getData() == nullptr) {
+        map = nullptr;
+        return false;
+    }
+    if (std::memcmp(getHeader()->magic, journalMagic, sizeof(journalMagic)) != 0) {
+        CYBR_LOG(edit, warn, "Not a cybr journal. Replacing it: " << file.getFullPathName());
+        map = nullptr;
+        file.deleteFile();
+        return open(recover);
+    }
+    int64 count = (int64)jmin<uint64>(getHeader()->numRecords, (uint64)getCapacity());
+    if (count > 0 && !recover) {
+        // These events belong to whatever edit was being recorded when they
+        // were written. Leave them for an explicit --recover-journal.
+        CYBR_LOG(edit, error, "Journal holds " << count << " events from an earlier session: "
+            << file.getFullPathName() << " (use -i edit --recover-journal=file -o edit to recover them)");
+        map = nullptr;
+        return false;
+    }
+    numRecords = count;
+    return true;
+}
+
+bool CybrJournal::growTo(int64 numBytes)
+{
+    // A MemoryMappedFile cannot change size, so extend the file, and map it
+    // again. This is rare, because we grow in big steps.
+    map = nullptr;
+    {
+        FileOutputStream out(file);
+        if (out.failedToOpen()) return false;
+        if (numBytes > file.getSize()) {
+            out.setPosition(numBytes - 1);
+            out.writeByte(0);
+        }
+        out.flush();
+    }
+    map = std::make_unique<MemoryMappedFile>(file, MemoryMappedFile::readWrite);
+    if (map->getData() == nullptr) {
+        map = nullptr;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    CybrJournal.h
+    Created: 18 Oct 2026 2:31:18pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "TimestampedTest.h"
+#include "CybrLog.h"
+
+class CybrTrackList;
+
+/** CybrJournal is an append-only log of CYBRTRACK events, stored in a memory
+ mapped file. During a long recording, CybrEdit writes events here instead of
+ adding them to the ValueTree, so memory use does not grow with the length of
+ the session. The events are compacted into the CYBRTRACKs when the edit is
+ saved.
+
+ Writing happens on a background thread. Events are passed to that thread
+ through a lock free queue, so appending is cheap on the message thread.
+ Because the file is memory mapped, records that were written survive a crash
+ of our process. The header's record count is only updated after the records
+ it refers to have been written, so a partially written record is never read.
+
+ A journal file that still contains records (because a previous session
+ crashed) is only reused when recovery is asked for explicitly. Its records
+ are then compacted into the edit on the next save. Otherwise it is left alone,
+ because its track indices refer to the edit that was being recorded, not to
+ ours.
+ */
+class CybrJournal : private Thread {
+public:
+    /** Open or create a journal file. If the file already holds records, it is
+     only opened when recover is true. */
+    CybrJournal(const File& file, bool recover = false);
+    ~CybrJournal();
+
+    /** Append an event. Call this on the message thread. If the writer
+     thread has fallen so far behind that the queue is full, this writes the
+     queue to the file itself, so events are never thrown away. */
+    void append(int trackIndex, double time, int value);
+
+    /** Write every appended event to the file before returning. Call this on
+     the message thread. */
+    void flush();
+
+    /** Wait for the writer thread, then add every journaled event to its track
+     and empty the journal. Call this on the message thread. */
+    void compactInto(CybrTrackList& trackList);
+
+    /** Number of records in the file that have not been compacted. Call
+     flush first to include events that are still queued. */
+    int64 getNumRecords() const { return numRecords; }
+
+    /** Number of events that could not be written, because the file could
+     not be grown */
+    int64 getNumDropped() const { return numDropped; }
+
+    const File& getFile() const { return file; }
+    bool isOpen() const { return opened; }
+
+private:
+    struct Record {
+        double time;
+        int32 value;
+        int32 trackIndex;
+    };
+
+    struct Header {
+        char magic[8];
+        uint64 numRecords;
+    };
+
+    void run() override;
+    /** Write everything that is in the queue to the file */
+    void writePending();
+    bool open(bool recover);
+    bool growTo(int64 numBytes);
+    Header* getHeader() const { return static_cast<Header*>(map->getData()); }
+    Record* getRecords() const { return reinterpret_cast<Record*>(getHeader() + 1); }
+    int64 getCapacity() const { return ((int64)map->getSize() - (int64)sizeof(Header)) / (int64)sizeof(Record); }
+
+    File file;
+    std::unique_ptr<MemoryMappedFile> map;
+    /** Held by whichever thread is touching the mapped file */
+    CriticalSection mapLock;
+    std::atomic<int64> numRecords { 0 };
+    std::atomic<int64> numDropped { 0 };
+    bool opened = false;
+
+    static constexpr int queueSize = 8192;
+    LockFreeQueue<Record, queueSize> queue;
+
+    static constexpr int64 growthBytes = 1024 * 1024;
+
+    JUCE_DECLARE_NON_COPYABLE(CybrJournal)
+};
@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+    CybrLog.cpp
+    Created: 18 Oct 2026 11:52:37pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "CybrLog.h"
+
+CybrLog& CybrLog::getInstance()
+{
+    static CybrLog instance;
+    return instance;
+}
+
+CybrLog::CybrLog() : Thread("Cybr Log")
+{
+    for (auto& t : thresholds) t.store(info, std::memory_order_relaxed);
+}
+
+CybrLog::~CybrLog()
+{
+    stop();
+}
+
+void CybrLog::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueLock);
+        running = true;
+    }
+    if (!isThreadRunning()) startThread(1);
+}
+
+void CybrLog::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueLock);
+        running = false;
+    }
+    stopThread(1000);
+    flush();
+}
+
+void CybrLog::setLevel(Category category, Level level)
+{
+    thresholds[category].store(level, std::memory_order_relaxed);
+}
+
+void CybrLog::setLevel(Level level)
+{
+    for (int c = 0; c < numCategories; c++) setLevel((Category)c, level);
+}
+
+const char* CybrLog::getLevelName(Level level)
+{
+    switch (level) {
+        case trace: return "trace";
+        case debug: return "debug";
+        case info: return "info";
+        case warn: return "warn";
+        case error: return "error";
+        case off: return "off";
+    }
+    return "";
+}
+
+const char* CybrLog::getCategoryName(Category category)
+{
+    switch (category) {
+        case general: return "general";
+        case edit: return "edit";
+        case plugin: return "plugin";
+        case device: return "device";
+        case server: return "server";
+        case numCategories: break;
+    }
+    return "";
+}
+
+Result CybrLog::configure(const String& spec)
+{
+    auto findLevel = [](const String& name, Level& level) {
+        for (int l = trace; l <= off; l++) {
+            if (name.equalsIgnoreCase(getLevelName((Level)l))) {
+                level = (Level)l;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // Check everything before changing anything
+    Array<std::pair<int, Level>> changes; // category -1 means every category
+    for (auto& item : StringArray::fromTokens(spec, ",", "")) {
+        item = item.trim();
+        if (item.isEmpty()) continue;
+        String categoryName = item.containsChar(':') ? item.upToFirstOccurrenceOf(":", false, false) : String();
+        String levelName = item.fromLastOccurrenceOf(":", false, false);
+        Level level;
+        if (!findLevel(levelName, level)) return Result::fail("Unknown log level: " + levelName);
+
+        int category = -1;
+        if (categoryName.isNotEmpty()) {
+            for (int c = 0; c < numCategories; c++)
+                if (categoryName.equalsIgnoreCase(getCategoryName((Category)c))) category = c;
+            if (category < 0) return Result::fail("Unknown log category: " + categoryName);
+        }
+        changes.add({ category, level });
+    }
+
+    for (auto& change : changes) {
+        if (change.first < 0) setLevel(change.second);
+        else setLevel((Category)change.first, change.second);
+    }
+    return Result::ok();
+}
+
+void CybrLog::write(Category category, Level level, std::string text)
+{
+    std::unique_lock<std::mutex> lock(queueLock);
+    if (running) {
+        if (queue.size() < maxQueuedLines) queue.push_back({ category, level, std::move(text) });
+        else numDropped++;
+        return;
+    }
+    lock.unlock();
+
+    // Nobody is printing the queue, so print the line now, after anything
+    // that is still waiting.
+    flush();
+    std::lock_guard<std::mutex> printingLock(printLock);
+    print({ category, level, std::move(text) });
+}
+
+void CybrLog::flush()
+{
+    std::lock_guard<std::mutex> printingLock(printLock);
+    int64 dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(queueLock);
+        printing.swap(queue);
+        std::swap(dropped, numDropped);
+    }
+    for (auto& entry : printing) print(entry);
+    if (dropped > 0)
+        print({ general, warn, "CybrLog: Dropped " + std::to_string(dropped) + " lines, because the output could not keep up" });
+    printing.clear(); // keeps the capacity, so the queues stop allocating
+}
+
+void CybrLog::print(const Entry& entry)
+{
+    if (entry.level == info) {
+        std::cout << entry.text << std::endl;
+        return;
+    }
+    auto& stream = entry.level >= warn ? std::cerr : std::cout;
+    stream << "[" << getLevelName(entry.level) << " " << getCategoryName(entry.category) << "] " << entry.text << std::endl;
+}
+
+void CybrLog::run()
+{
+    while (!threadShouldExit()) {
+        flush();
+        wait(20);
+    }
+}
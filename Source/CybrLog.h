@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    CybrLog.h
+    Created: 18 Oct 2026 11:52:37pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <iostream>
+#include <sstream>
+#include <mutex>
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** CybrLog is the leveled log for the message thread and worker threads. Each
+ line has a category and a level. Each category has its own threshold, and
+ lines below the threshold are discarded before they are formatted.
+
+ Writing a line only appends it to a queue. A background thread prints the
+ queue, so an OSC handler does not wait for the terminal. info lines are
+ printed as they are, to stdout. Other levels are prefixed with the level and
+ category, and warn and error lines go to stderr. If the output stalls and the
+ queue holds maxQueuedLines, new lines are dropped, and the number dropped is
+ printed once the output catches up.
+
+ Use the CYBR_LOG macro, which checks the threshold before it evaluates the
+ expression. Anything that can be written to a std::ostream may be logged:
+
+     CYBR_LOG(server, debug, "set " << paramName << " to " << paramValue);
+
+ Note that writing may allocate and lock. From the audio thread, use
+ RealtimeLog instead.
+ */
+class CybrLog : private Thread {
+public:
+    enum Level { trace = 0, debug, info, warn, error, off };
+    enum Category { general = 0, edit, plugin, device, server, numCategories };
+
+    static CybrLog& getInstance();
+
+    /** Start and stop the thread that prints the queue. Call on the message
+     thread. While it is stopped, lines are printed immediately. */
+    void start();
+    void stop();
+
+    bool isEnabled(Category category, Level level) const noexcept {
+        return level >= thresholds[category].load(std::memory_order_relaxed);
+    }
+
+    void setLevel(Category category, Level level);
+    void setLevel(Level level); // every category
+
+    /** Set thresholds from a comma separated list like "debug" or
+     "warn,server:debug,plugin:trace". A bare level applies to every category. */
+    Result configure(const String& spec);
+
+    void write(Category category, Level level, std::string text);
+
+    /** Lines that are waiting to be printed, beyond which new lines are
+     dropped */
+    static constexpr size_t maxQueuedLines = 10000;
+
+    /** Print everything in the queue now */
+    void flush();
+
+    static const char* getLevelName(Level level);
+    static const char* getCategoryName(Category category);
+
+private:
+    struct Entry {
+        Category category;
+        Level level;
+        std::string text;
+    };
+
+    CybrLog();
+    ~CybrLog();
+    void run() override;
+    void print(const Entry& entry);
+
+    std::atomic<int> thresholds[numCategories];
+    std::mutex queueLock;
+    std::vector<Entry> queue;
+    bool running = false; // guarded by queueLock
+    int64 numDropped = 0; // guarded by queueLock
+    std::mutex printLock;  // keeps lines whole when stop races the thread
+    std::vector<Entry> printing;
+
+    JUCE_DECLARE_NON_COPYABLE(CybrLog)
+};
+
+#define CYBR_LOG(category, level, expression) \
+    do { \
+        auto& cybrLog_ = CybrLog::getInstance(); \
+        if (cybrLog_.isEnabled(CybrLog::category, CybrLog::level)) { \
+            std::ostringstream cybrLogStream_; \
+            cybrLogStream_ << expression; \
+            cybrLog_.write(CybrLog::category, CybrLog::level, cybrLogStream_.str()); \
+        } \
+    } while (false)
@@ -33,13 +33,23 @@ public:
     /** Add an event to the track unless the supplied time is less than
         the previously added event time. Returns true on success. */
     bool addEvent(double time, int value) {
-        if (time >= lastEventTime) {
-            lastEventTime = time;
-            state.addChild({CE, {{te::IDs::t, time}, {te::IDs::v, value}}}, -1, nullptr);
-            return true;
-        } else {
-            return false;
-        }
+        if (!claimEventTime(time)) return false;
+        appendEvent(time, value);
+        return true;
+    }
+
+    /** Check that an event at the supplied time would be accepted by addEvent,
+        and if so, advance lastEventTime as though it had been added. Used when
+        the event is stored somewhere else first (see CybrJournal). */
+    bool claimEventTime(double time) {
+        if (time < lastEventTime) return false;
+        lastEventTime = time;
+        return true;
+    }
+
+    /** Add an event to the end of the track without checking its time */
+    void appendEvent(double time, int value) {
+        state.addChild({CE, {{te::IDs::t, time}, {te::IDs::v, value}}}, -1, nullptr);
     }
 
     ValueTree state;
@@ -69,5 +79,14 @@ public:
         if (size() == 0) appendEmptyTrack();
         return at(size() - 1);
     }
+
+    int getNumTracks() const { return size(); }
+
+    /** Get the track at index. If there is no track at that index, get the
+        last track (creating it if needed). */
+    CybrTrack* getTrackOrLast(int index) {
+        if (index >= 0 && index < size()) return at(index);
+        return getOrCreateLastTrack();
+    }
     CybrEdit& cybr;
 };
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    EditAnalysis.cpp
+    Created: 18 Oct 2026 7:48:03pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "EditAnalysis.h"
+
+EditAnalysis::EditAnalysis(te::Edit& source) :
+    edit(copyEditForRendering(source))
+{
+}
+
+EditAnalysis::~EditAnalysis()
+{
+    trackTaps.clear();
+    masterTap = nullptr;
+}
+
+bool EditAnalysis::prepare()
+{
+    int index = 0;
+    for (auto* track : te::getAudioTracks(*edit)) {
+        // Appending puts the tap after the track's volume and pan, so we
+        // measure what the track contributes to the mix.
+        auto plugin = track->pluginList.insertPlugin(LoudnessTapPlugin::create(), -1);
+        if (!dynamic_cast<LoudnessTapPlugin*>(plugin.get())) {
+            std::cerr << "EditAnalysis: Failed to create a LoudnessTapPlugin. Is it registered?" << std::endl;
+            return false;
+        }
+        trackTaps.add({ track->getName(), index++, plugin });
+    }
+
+    masterTap = edit->getMasterPluginList().insertPlugin(LoudnessTapPlugin::create(), -1);
+    return dynamic_cast<LoudnessTapPlugin*>(masterTap.get()) != nullptr;
+}
+
+void EditAnalysis::run()
+{
+    BigInteger tracksToDo;
+    int trackCount = te::getAllTracks(*edit).size();
+    for (int i = 0; i < trackCount; i++) tracksToDo.setBit(i);
+
+    // measureStatistics renders the edit without writing a file. We only use
+    // it to drive the render. The taps do the measuring.
+    te::Renderer::measureStatistics("Cybr Analysis", *edit, { 0.0, edit->getLength() }, tracksToDo, 512);
+}
+
+var EditAnalysis::getReport() const
+{
+    auto* obj = new DynamicObject();
+    var report(obj);
+    obj->setProperty("length", edit->getLength());
+
+    if (auto* tap = dynamic_cast<LoudnessTapPlugin*>(masterTap.get()))
+        obj->setProperty("master", tap->getResults().toVar());
+
+    Array<var> tracks;
+    for (auto& t : trackTaps) {
+        auto* tap = dynamic_cast<LoudnessTapPlugin*>(t.plugin.get());
+        if (!tap) continue;
+        var result = tap->getResults().toVar();
+        result.getDynamicObject()->setProperty("name", t.trackName);
+        result.getDynamicObject()->setProperty("index", t.trackIndex);
+        tracks.add(result);
+    }
+    obj->setProperty("tracks", tracks);
+    return report;
+}
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    EditAnalysis.h
+    Created: 18 Oct 2026 7:48:03pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <iostream>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "LoudnessTapPlugin.h"
+#include "cybr_helpers.h"
+
+namespace te = tracktion_engine;
+
+/** EditAnalysis measures the loudness and peaks of every audio track, and of
+ the master mix, in a single render that does not write any audio files.
+
+ It works on a copy of the edit, so the source edit is never changed. A
+ LoudnessTapPlugin is added to the end of each audio track's plugin list, and
+ to the master plugin list. While tracktion renders (mixing tracks on its own
+ pool of mixer threads) each tap measures the audio that passes through it.
+
+ Use it in three steps:
+     EditAnalysis analysis(edit);
+     analysis.prepare();          // message thread
+     analysis.run();              // render
+     var report = analysis.getReport();
+ */
+class EditAnalysis {
+public:
+    /** Copy the source edit. Call this on the message thread. */
+    EditAnalysis(te::Edit& source);
+    ~EditAnalysis();
+
+    /** Add the taps. Call this on the message thread. Returns false if the
+     LoudnessTapPlugin type has not been registered. */
+    bool prepare();
+
+    /** Render the whole edit through the taps */
+    void run();
+
+    /** A JSON object with the results for the master and for each track:
+     { "length": 12.5, "master": {...}, "tracks": [{"name": "Bass", "index": 0, ...}] }
+     See LoudnessAnalyser::Results::toVar for the fields of each result. */
+    var getReport() const;
+
+    /** The copy that contains the taps. Rendering this edit some other way
+     (for example, to a .wav file) measures it just like run() does. */
+    te::Edit& getEdit() { return *edit; }
+
+private:
+    std::unique_ptr<te::Edit> edit;
+
+    struct Tap {
+        String trackName;
+        int trackIndex;
+        te::Plugin::Ptr plugin;
+    };
+    Array<Tap> trackTaps;
+    te::Plugin::Ptr masterTap;
+
+    JUCE_DECLARE_NON_COPYABLE(EditAnalysis)
+};
@@ -0,0 +1,202 @@
+/*
+  ==============================================================================
+
+    EditBatch.cpp
+    Created: 18 Oct 2026 9:41:27pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "EditBatch.h"
+
+static bool isSet(const File& file) { return file != File(); }
+
+struct EditBatch::Item {
+    Job job;
+    double startMs = Time::getMillisecondCounterHiRes();
+
+    // Declaration order matters: the task refers to one of the edits, so it
+    // must be deleted first.
+    std::unique_ptr<CybrEdit> cybrEdit;
+    std::unique_ptr<EditAnalysis> analysis;
+    std::unique_ptr<te::Renderer::RenderTask> task;
+};
+
+Result EditBatch::Manifest::fromFile(const File& file, Manifest& manifest)
+{
+    if (!file.existsAsFile()) return Result::fail("Manifest file does not exist: " + file.getFullPathName());
+    var json;
+    auto result = JSON::parse(file.loadFileAsString(), json);
+    if (result.failed()) return result;
+
+    const File base = file.getParentDirectory();
+    var jobs = json.isArray() ? json : json.getProperty("jobs", var());
+    if (!jobs.isArray() || jobs.size() == 0) return Result::fail("Manifest has no jobs");
+
+    manifest.numThreads = json.isObject() ? (int)json.getProperty("threads", 0) : 0;
+    manifest.jobs.clear();
+    for (int i = 0; i < jobs.size(); i++) {
+        const var& j = jobs[i];
+        String input = j.getProperty("input", "").toString();
+        if (input.isEmpty()) return Result::fail("Job " + String(i) + " has no input");
+
+        Job job;
+        job.input = base.getChildFile(input);
+        String save = j.getProperty("save", "").toString();
+        String render = j.getProperty("render", "").toString();
+        var analyze = j.getProperty("analyze", var());
+        if (save.isNotEmpty()) job.save = base.getChildFile(save);
+        if (render.isNotEmpty()) job.render = base.getChildFile(render);
+        if (analyze.isBool()) job.printAnalysis = (bool)analyze;
+        else if (analyze.toString().isNotEmpty()) job.analyze = base.getChildFile(analyze.toString());
+
+        if (!isSet(job.save) && !isSet(job.render) && !isSet(job.analyze) && !job.printAnalysis)
+            return Result::fail("Job " + String(i) + " has nothing to do. Add save, render or analyze.");
+        manifest.jobs.add(job);
+    }
+    return Result::ok();
+}
+
+//==============================================================================
+EditBatch::EditBatch(te::Engine& e, const Manifest& manifest) :
+    engine(e),
+    jobs(manifest.jobs),
+    numThreads(manifest.numThreads > 0 ? manifest.numThreads : SystemStats::getNumCpus()),
+    pool(numThreads)
+{
+}
+
+EditBatch::~EditBatch()
+{
+    // Stop the renders before the edits they use are deleted
+    pool.removeAllJobs(true, 5000);
+    inFlight.clear();
+}
+
+void EditBatch::start()
+{
+    startMs = Time::getMillisecondCounterHiRes();
+    std::cout << "Batch: " << jobs.size() << " jobs on " << numThreads << " threads" << std::endl;
+    loadMore();
+}
+
+void EditBatch::loadMore()
+{
+    while (inFlight.size() < numThreads * 2 && nextJob < jobs.size()) {
+        auto* item = inFlight.add(new Item());
+        item->job = jobs[nextJob++];
+
+        if (!prepare(*item)) continue; // prepare reported the error
+        if (!item->task) {
+            complete(*item); // nothing to render, just save
+            continue;
+        }
+
+        WeakReference<EditBatch> weakThis(this);
+        pool.addJob([item, weakThis] {
+            auto* job = ThreadPoolJob::getCurrentThreadPoolJob();
+            while (item->task->runJob() == ThreadPoolJob::jobNeedsRunningAgain)
+                if (job && job->shouldExit()) return;
+            MessageManager::callAsync([item, weakThis] {
+                if (auto* batch = weakThis.get()) batch->renderFinished(item);
+            });
+        });
+    }
+
+    if (numDone == jobs.size() && inFlight.isEmpty()) {
+        std::cerr
+            << "Batch finished " << numDone << " jobs (" << numFailed << " failed) in "
+            << (Time::getMillisecondCounterHiRes() - startMs) / 1000.0 << " seconds" << std::endl;
+        if (onFinished) onFinished();
+    }
+}
+
+bool EditBatch::prepare(Item& item)
+{
+    const Job& job = item.job;
+    if (!job.input.existsAsFile()) {
+        report(item, false, "Input file does not exist");
+        return false;
+    }
+
+    item.cybrEdit = std::make_unique<CybrEdit>(createEdit(job.input, engine));
+    te::Edit* edit = &item.cybrEdit->getEdit();
+
+    // When analyzing, render the copy with the taps in it, so a job that
+    // renders and analyzes only renders once.
+    if (isSet(job.analyze) || job.printAnalysis) {
+        item.analysis = std::make_unique<EditAnalysis>(*edit);
+        if (!item.analysis->prepare()) {
+            report(item, false, "Failed to prepare analysis");
+            return false;
+        }
+        edit = &item.analysis->getEdit();
+    }
+    if (!item.analysis && !isSet(job.render)) return true;
+
+    // A file left by an earlier run must not look like this one succeeded
+    if (isSet(job.render) && job.render.existsAsFile() && !job.render.deleteFile()) {
+        report(item, false, "Failed to remove the old render: " + job.render.getFullPathName());
+        return false;
+    }
+
+    // The task builds its audio graph here, on the message thread. Only
+    // runJob is called from the pool.
+    item.task = createRenderTask(*edit, job.render, "Batch: " + job.input.getFileName());
+    return true;
+}
+
+void EditBatch::renderFinished(Item* item)
+{
+    complete(*item);
+    loadMore();
+}
+
+void EditBatch::complete(Item& item)
+{
+    const Job& job = item.job;
+    const String error = item.task ? item.task->errorMessage : String();
+    item.task = nullptr;
+
+    if (error.isNotEmpty() || (isSet(job.render) && !job.render.existsAsFile())) {
+        report(item, false, "Failed to render: " + job.render.getFullPathName()
+            + (error.isNotEmpty() ? " (" + error + ")" : String()));
+        return;
+    }
+
+    var analysis;
+    if (item.analysis) {
+        analysis = item.analysis->getReport();
+        if (isSet(job.analyze)) {
+            job.analyze.getParentDirectory().createDirectory();
+            if (!job.analyze.replaceWithText(JSON::toString(analysis))) {
+                report(item, false, "Failed to save analysis: " + job.analyze.getFullPathName());
+                return;
+            }
+        }
+    }
+
+    if (isSet(job.save)) {
+        job.save.getParentDirectory().createDirectory();
+        item.cybrEdit->saveActiveEdit(job.save);
+    }
+
+    report(item, true, {}, job.printAnalysis ? analysis : var());
+}
+
+void EditBatch::report(Item& item, bool ok, const String& error, const var& analysis)
+{
+    auto* obj = new DynamicObject();
+    var line(obj);
+    obj->setProperty("input", item.job.input.getFullPathName());
+    obj->setProperty("ok", ok);
+    obj->setProperty("seconds", (Time::getMillisecondCounterHiRes() - item.startMs) / 1000.0);
+    if (error.isNotEmpty()) obj->setProperty("error", error);
+    if (!analysis.isVoid()) obj->setProperty("analysis", analysis);
+    std::cout << JSON::toString(line, true) << std::endl;
+
+    numDone++;
+    if (!ok) numFailed++;
+    inFlight.removeObject(&item);
+}
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    EditBatch.h
+    Created: 18 Oct 2026 9:41:27pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <iostream>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "cybr_helpers.h"
+#include "CybrEdit.h"
+#include "EditAnalysis.h"
+
+namespace te = tracktion_engine;
+
+/** EditBatch saves, renders and analyzes many edits in one process. Starting
+ cybr once per edit means creating an engine, reading the plugin list, and
+ opening the same audio files again for every edit. In a batch, every edit
+ shares one engine, so plugin binaries and audio file readers are loaded once.
+
+ A manifest is a JSON object (or just the array of jobs). Paths are relative
+ to the manifest file:
+ {
+   "threads": 4,                      // render threads. Default: number of CPUs
+   "jobs": [
+     { "input": "a.tracktionedit",
+       "save": "out/a.tracktionedit",   // each operation is optional
+       "render": "out/a.wav",
+       "analyze": "out/a.json" },       // or true, to print the report
+     { "input": "b.tracktionedit", "analyze": true }
+   ]
+ }
+
+ Tracktion requires that edits are created on the message thread, so edits
+ are loaded there, one at a time. Rendering is the slow part, and that runs
+ on a pool of worker threads while the next edits load. When a job renders
+ and analyzes, both happen in the same pass. To bound memory, at most twice
+ as many edits as there are threads are loaded at once.
+
+ One line of JSON is printed for each job as it finishes:
+ { "input": "...", "ok": true, "seconds": 1.2, "analysis": {...} }
+ */
+class EditBatch {
+public:
+    struct Job {
+        File input;
+        File save;
+        File render;
+        File analyze;
+        bool printAnalysis = false;
+    };
+
+    struct Manifest {
+        int numThreads = 0;
+        Array<Job> jobs;
+
+        /** Parse a manifest. If the file does not exist or cannot be parsed,
+         the Result explains why. */
+        static Result fromFile(const File& file, Manifest& manifest);
+    };
+
+    EditBatch(te::Engine& engine, const Manifest& manifest);
+    ~EditBatch();
+
+    /** Begin loading and rendering. Call this on the message thread. */
+    void start();
+
+    /** Called on the message thread when every job has finished */
+    std::function<void()> onFinished;
+
+    int getNumFailed() const { return numFailed; }
+
+private:
+    struct Item;
+
+    /** Load edits until the window is full. Message thread only. */
+    void loadMore();
+    /** Load an edit, and prepare its render. On failure, report the error
+     and return false. */
+    bool prepare(Item& item);
+    /** Called on the message thread after an item's render has finished */
+    void renderFinished(Item* item);
+    /** Write the analysis, save the edit, and report */
+    void complete(Item& item);
+    /** Print the result line for an item, and delete it */
+    void report(Item& item, bool ok, const String& error = {}, const var& analysis = {});
+
+    te::Engine& engine;
+    Array<Job> jobs;
+    int numThreads;
+    int nextJob = 0;
+    int numDone = 0;
+    int numFailed = 0;
+    double startMs = 0;
+
+    OwnedArray<Item> inFlight;
+    ThreadPool pool;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(EditBatch)
+    JUCE_DECLARE_NON_COPYABLE(EditBatch)
+};
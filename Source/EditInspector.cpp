@@ -0,0 +1,304 @@
+/*
+  ==============================================================================
+
+    EditInspector.cpp
+    Created: 18 Oct 2026 9:05:12pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "EditInspector.h"
+
+static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+String XmlTagScanner::Tag::get(const char* attributeName) const
+{
+    for (auto& a : attributes) if (a.first == attributeName) return a.second;
+    return {};
+}
+
+bool XmlTagScanner::skipPast(const char* terminator)
+{
+    const int length = (int)strlen(terminator);
+    int matched = 0;
+    while (!stream.isExhausted()) {
+        char c = stream.readByte();
+        if (c == terminator[matched]) {
+            if (++matched == length) return true;
+        } else {
+            matched = (c == terminator[0]) ? 1 : 0;
+        }
+    }
+    return false;
+}
+
+String XmlTagScanner::decodeEntities(const std::string& s)
+{
+    String result = String::fromUTF8(s.data(), (int)s.size());
+    if (!result.containsChar('&')) return result;
+
+    String decoded;
+    auto t = result.getCharPointer();
+    while (!t.isEmpty()) {
+        juce_wchar c = t.getAndAdvance();
+        if (c != '&') {
+            decoded << String::charToString(c);
+            continue;
+        }
+        String entity;
+        while (!t.isEmpty() && *t != ';' && entity.length() < 10) entity << String::charToString(t.getAndAdvance());
+        if (!t.isEmpty() && *t == ';') ++t;
+
+        if (entity == "amp") decoded << "&";
+        else if (entity == "lt") decoded << "<";
+        else if (entity == "gt") decoded << ">";
+        else if (entity == "quot") decoded << "\"";
+        else if (entity == "apos") decoded << "'";
+        else if (entity.startsWith("#x")) decoded << String::charToString((juce_wchar)entity.substring(2).getHexValue32());
+        else if (entity.startsWith("#")) decoded << String::charToString((juce_wchar)entity.substring(1).getIntValue());
+        else decoded << "&" << entity << ";";
+    }
+    return decoded;
+}
+
+bool XmlTagScanner::next(Tag& tag)
+{
+    tag.name.clear();
+    tag.isEnd = false;
+    tag.isSelfClosing = false;
+    tag.attributes.clear();
+
+    for (;;) {
+        // Skip text content
+        char c = 0;
+        while (c != '<') {
+            if (stream.isExhausted()) return false;
+            c = stream.readByte();
+        }
+        if (stream.isExhausted()) return false;
+        c = stream.readByte();
+
+        if (c == '?') {
+            if (!skipPast("?>")) return false;
+            continue;
+        }
+        if (c == '!') {
+            // A comment, CDATA section or DOCTYPE
+            char kind = stream.readByte();
+            if (!skipPast(kind == '-' ? "-->" : kind == '[' ? "]]>" : ">")) return false;
+            continue;
+        }
+
+        if (c == '/') {
+            tag.isEnd = true;
+            nameBuffer.clear();
+            for (;;) {
+                if (stream.isExhausted()) return false;
+                c = stream.readByte();
+                if (c == '>') break;
+                if (!isSpace(c)) nameBuffer += c;
+            }
+            tag.name = String::fromUTF8(nameBuffer.data(), (int)nameBuffer.size());
+            return true;
+        }
+
+        nameBuffer.assign(1, c);
+        for (;;) {
+            if (stream.isExhausted()) return false;
+            c = stream.readByte();
+            if (isSpace(c) || c == '/' || c == '>') break;
+            nameBuffer += c;
+        }
+        tag.name = String::fromUTF8(nameBuffer.data(), (int)nameBuffer.size());
+
+        // Attributes
+        for (;;) {
+            while (isSpace(c)) {
+                if (stream.isExhausted()) return false;
+                c = stream.readByte();
+            }
+            if (c == '>') return true;
+            if (c == '/') {
+                tag.isSelfClosing = true;
+                return skipPast(">");
+            }
+
+            nameBuffer.assign(1, c);
+            for (;;) {
+                if (stream.isExhausted()) return false;
+                c = stream.readByte();
+                if (c == '=' || isSpace(c)) break;
+                nameBuffer += c;
+            }
+            while (c != '"' && c != '\'') {
+                if (stream.isExhausted()) return false;
+                c = stream.readByte();
+            }
+            const char quote = c;
+            valueBuffer.clear();
+            for (;;) {
+                if (stream.isExhausted()) return false;
+                c = stream.readByte();
+                if (c == quote) break;
+                valueBuffer += c;
+            }
+            tag.attributes.emplace_back(String::fromUTF8(nameBuffer.data(), (int)nameBuffer.size()),
+                                        decodeEntities(valueBuffer));
+            if (stream.isExhausted()) return false;
+            c = stream.readByte();
+        }
+    }
+}
+
+//==============================================================================
+var EditInspector::inspect(const File& file)
+{
+    auto* edit = new DynamicObject();
+    var result(edit);
+    edit->setProperty("file", file.getFullPathName());
+
+    FileInputStream in(file);
+    if (in.failedToOpen()) {
+        edit->setProperty("error", "Failed to open file");
+        return result;
+    }
+    // XML edits start with '<' (or a UTF-8 byte order mark). Anything else is
+    // probably a binary ValueTree, which only te::loadEditFromFile can read.
+    const uint8 first = (uint8)in.readByte();
+    if (first != '<' && first != 0xef && !isSpace((char)first)) {
+        edit->setProperty("error", "Not an XML edit");
+        return result;
+    }
+    in.setPosition(0);
+
+    Array<var> tracks;
+    StringArray sources;
+    int numClips = 0, numNotes = 0;
+
+    // Tracks inside a FOLDERTRACK are open at the same time as the folder, so
+    // keep a stack of them. Clips and plugins belong to the innermost one.
+    struct OpenTrack {
+        DynamicObject::Ptr object;
+        Array<var> clips;
+        StringArray plugins;
+        int notes = 0;
+        int depth = -1;
+    };
+    std::vector<OpenTrack> openTracks;
+    DynamicObject::Ptr clip;
+    int clipNotes = 0;
+    int clipDepth = -1;
+
+    std::vector<String> stack;
+    XmlTagScanner scanner(in);
+    XmlTagScanner::Tag tag;
+    bool foundEdit = false;
+
+    while (scanner.next(tag)) {
+        if (tag.isEnd) {
+            if (stack.empty()) break;
+            stack.pop_back();
+        } else {
+            if (stack.empty() && tag.name == "EDIT") foundEdit = true;
+            const String parent = stack.empty() ? String() : stack.back();
+            const int depth = (int)stack.size();
+            OpenTrack* track = openTracks.empty() ? nullptr : &openTracks.back();
+
+            if (!clip && tag.name.endsWith("TRACK") && (parent == "EDIT" || parent == "FOLDERTRACK")) {
+                OpenTrack opened;
+                opened.object = new DynamicObject();
+                opened.object->setProperty("type", tag.name);
+                opened.object->setProperty("name", tag.get("name"));
+                if (track) opened.object->setProperty("folder", track->object->getProperty("name"));
+                opened.depth = depth;
+                // Add it now, so that tracks are listed in the order they
+                // appear in the file, with folders before their children
+                tracks.add(var(opened.object.get()));
+                openTracks.push_back(opened);
+            } else if (track && !clip && tag.name.endsWith("CLIP")) {
+                clip = new DynamicObject();
+                clip->setProperty("type", tag.name);
+                clip->setProperty("name", tag.get("name"));
+                clip->setProperty("start", tag.get("start").getDoubleValue());
+                clip->setProperty("length", tag.get("length").getDoubleValue());
+                String source = tag.get("source");
+                if (source.isNotEmpty()) {
+                    clip->setProperty("source", source);
+                    sources.addIfNotAlreadyThere(source);
+                }
+                clipNotes = 0;
+                clipDepth = depth;
+                numClips++;
+            } else if (clip && tag.name == "NOTE") {
+                clipNotes++;
+                track->notes++;
+                numNotes++;
+            } else if (track && !clip && tag.name == "PLUGIN" && depth == track->depth + 1) {
+                String name = tag.get("name");
+                track->plugins.add(name.isNotEmpty() ? name : tag.get("type"));
+            }
+
+            if (!tag.isSelfClosing) stack.push_back(tag.name);
+        }
+
+        // Close the clip or tracks whose element just ended
+        const int depth = (int)stack.size();
+        if (clip && depth <= clipDepth) {
+            clip->setProperty("notes", clipNotes);
+            openTracks.back().clips.add(var(clip.get()));
+            clip = nullptr;
+        }
+        while (!openTracks.empty() && depth <= openTracks.back().depth) {
+            auto& closed = openTracks.back();
+            closed.object->setProperty("notes", closed.notes);
+            closed.object->setProperty("plugins", closed.plugins);
+            closed.object->setProperty("clips", closed.clips);
+            openTracks.pop_back();
+        }
+    }
+
+    if (!foundEdit) {
+        edit->setProperty("error", "No EDIT element found");
+        return result;
+    }
+    edit->setProperty("numTracks", tracks.size());
+    edit->setProperty("numClips", numClips);
+    edit->setProperty("numNotes", numNotes);
+    edit->setProperty("sources", sources);
+    edit->setProperty("tracks", tracks);
+    return result;
+}
+
+void EditInspector::inspectAll(const File& fileOrDirectory, int numThreads)
+{
+    Array<File> files;
+    if (fileOrDirectory.isDirectory())
+        files = fileOrDirectory.findChildFiles(File::findFiles, true, "*.tracktionedit");
+    else if (fileOrDirectory.existsAsFile())
+        files.add(fileOrDirectory);
+
+    if (files.isEmpty()) {
+        std::cerr << "No .tracktionedit files found: " << fileOrDirectory.getFullPathName() << std::endl;
+        return;
+    }
+
+    // Each line is written whole, so output from different threads does not
+    // interleave. Lines come out in the order that files finish.
+    CriticalSection printLock;
+    const double startMs = Time::getMillisecondCounterHiRes();
+    {
+        ThreadPool pool(jmax(1, numThreads));
+        for (auto& file : files) {
+            pool.addJob([file, &printLock] {
+                String line = JSON::toString(inspect(file), true);
+                const ScopedLock sl (printLock);
+                std::cout << line << std::endl;
+            });
+        }
+        while (pool.getNumJobs() > 0) Thread::sleep(5);
+    }
+    std::cerr
+        << "Inspected " << files.size() << " edits in "
+        << (Time::getMillisecondCounterHiRes() - startMs) / 1000.0 << " seconds" << std::endl;
+}
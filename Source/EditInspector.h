@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    EditInspector.h
+    Created: 18 Oct 2026 9:05:12pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <iostream>
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** XmlTagScanner reads XML one tag at a time from a stream, without building a
+ document. Text content, comments, processing instructions and CDATA are
+ skipped. It is not a validating parser. It understands just enough XML to
+ read the tags and attributes of a .tracktionedit file.
+ */
+class XmlTagScanner {
+public:
+    struct Tag {
+        String name;
+        bool isEnd = false;
+        bool isSelfClosing = false;
+        std::vector<std::pair<String, String>> attributes;
+
+        /** Returns the value of an attribute, or an empty string */
+        String get(const char* attributeName) const;
+    };
+
+    XmlTagScanner(InputStream& source) : stream(&source, 65536, false) {}
+
+    /** Read the next start or end tag. Returns false at the end of the stream */
+    bool next(Tag& tag);
+
+private:
+    bool skipPast(const char* terminator);
+    static String decodeEntities(const std::string& s);
+
+    BufferedInputStream stream;
+    std::string nameBuffer, valueBuffer;
+};
+
+/** EditInspector summarizes a .tracktionedit file (tracks, clips, plugins,
+ note counts and audio sources) by streaming through its XML. Unlike -i, it
+ does not create a te::Edit, resolve clip sources, or check plugins, so it is
+ cheap enough to run on thousands of files. Every method is safe to call from
+ any thread.
+
+ Binary (non XML) edit files are not supported, and are reported as errors.
+ */
+class EditInspector {
+public:
+    /** Returns a JSON object that describes the edit:
+     { "file": "...", "tracks": [{ "type": "TRACK", "name": "Bass", "notes": 12,
+       "plugins": ["volume", "4osc"], "clips": [{ "type": "MIDICLIP", "name": "..",
+       "start": 0.0, "length": 4.0, "notes": 12 }] }], "numTracks": .., "numClips": ..,
+       "numNotes": .., "sources": [".."] }
+     Tracks inside a folder track get their own entry, after the folder, with
+     a "folder" property that names it. If the file cannot be read, the object has an "error" property instead. */
+    static var inspect(const File& file);
+
+    /** Inspect a file, or every .tracktionedit file in a directory (and its
+     subdirectories), on a pool of numThreads threads. Prints one line of JSON
+     per file as each one finishes. Blocks until all of them are done. */
+    static void inspectAll(const File& fileOrDirectory, int numThreads);
+};
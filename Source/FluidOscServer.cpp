@@ -11,52 +11,214 @@
 #include "FluidOscServer.h"
 
 FluidOscServer::FluidOscServer() {
+    // Create the weak reference here, on the message thread. The receiver
+    // thread copies it.
+    weakThis = this;
     addListener (this);
+    // Stream packets arrive on the message thread, like UDP packets, so both
+    // transports share the same handlers and sessions.
+    streamServer.onMessage = [this](const OSCMessage& message) { handleMessage(message); };
+    streamServer.onBundle = [this](const OSCBundle& bundle) { handleBundle(bundle); };
+}
+
+FluidOscServer::~FluidOscServer() {
+    // Stop the receiver thread before our members are deleted
+    removeListener(this);
+    disconnect();
+    // Renders run on the UIBehaviour's pool, which outlives us
+    if (auto* ui = getUiBehaviour())
+        for (auto* render : renders) ui->cancelTask(*render->task);
+}
+
+//==============================================================================
+/** Consecutive /plugin/param/set messages that have not reached the message
+ thread yet. A newer value for the same parameter replaces the older one. */
+struct FluidOscServer::ParamSetBatch {
+    SpinLock lock;
+    bool taken = false; // the message thread has started on this batch
+    Array<OSCMessage> messages;
+};
+
+bool FluidOscServer::coalesceParamSet(const OSCMessage& message) {
+    if (!message.getAddressPattern().matches({"/plugin/param/set"})
+        || message.size() < 2 || !message[0].isString()) {
+        // Anything else (like /plugin/select) must be handled between the
+        // messages before and after it, so it ends the batch.
+        openParamSetBatch = nullptr;
+        return false;
+    }
+
+    const String name = message[0].getString();
+    if (openParamSetBatch) {
+        const SpinLock::ScopedLockType sl(openParamSetBatch->lock);
+        if (!openParamSetBatch->taken) {
+            auto& messages = openParamSetBatch->messages;
+            for (auto& m : messages) {
+                if (m[0].getString() == name) {
+                    m = message;
+                    stats.recordCoalesced();
+                    return true;
+                }
+            }
+            messages.add(message);
+            return true;
+        }
+    }
+
+    auto batch = std::make_shared<ParamSetBatch>();
+    batch->messages.add(message);
+    openParamSetBatch = batch;
+    queuedPackets++;
+    auto weak = weakThis;
+    const double receivedMs = Time::getMillisecondCounterHiRes();
+    MessageManager::callAsync([weak, batch, receivedMs] {
+        Array<OSCMessage> messages;
+        {
+            const SpinLock::ScopedLockType sl(batch->lock);
+            batch->taken = true;
+            messages.swapWith(batch->messages);
+        }
+        if (auto* server = weak.get()) {
+            server->queuedPackets--;
+            server->stats.recordQueueDelay((Time::getMillisecondCounterHiRes() - receivedMs) * 1000.0);
+            for (auto& m : messages) server->handleMessage(m);
+        }
+    });
+    return true;
+}
+
+void FluidOscServer::oscMessageReceived(const OSCMessage& message) {
+    if (coalesceParamSet(message)) return;
+    queuedPackets++;
+    auto weak = weakThis;
+    const double receivedMs = Time::getMillisecondCounterHiRes();
+    MessageManager::callAsync([weak, message, receivedMs] {
+        if (auto* server = weak.get()) {
+            server->queuedPackets--;
+            server->stats.recordQueueDelay((Time::getMillisecondCounterHiRes() - receivedMs) * 1000.0);
+            server->handleMessage(message);
+        }
+    });
+}
+
+void FluidOscServer::oscBundleReceived(const OSCBundle& bundle) {
+    openParamSetBatch = nullptr;
+    queuedPackets++;
+    auto weak = weakThis;
+    const double receivedMs = Time::getMillisecondCounterHiRes();
+    MessageManager::callAsync([weak, bundle, receivedMs] {
+        if (auto* server = weak.get()) {
+            server->queuedPackets--;
+            server->stats.recordQueueDelay((Time::getMillisecondCounterHiRes() - receivedMs) * 1000.0);
+            server->handleBundle(bundle);
+        }
+    });
+}
+
+bool FluidOscServer::listenForStreams(int port) {
+    return streamServer.start(port);
 }
 
-void FluidOscServer::oscBundleReceived(const juce::OSCBundle &bundle) {
+void FluidOscServer::handleBundle(const juce::OSCBundle &bundle) {
+    if (bundleDepth == 0) bundleStartMs = Time::getMillisecondCounterHiRes();
+    bundleDepth++;
     for (const auto& element: bundle) {
-        if (element.isMessage()) oscMessageReceived(element.getMessage());
-        if (element.isBundle()) oscBundleReceived(element.getBundle());
+        if (element.isMessage()) handleMessage(element.getMessage());
+        if (element.isBundle()) handleBundle(element.getBundle());
+    }
+    bundleDepth--;
+
+    // Parameter values from the bundle may still be waiting for the audio
+    // thread. Apply them, so an ack means that the bundle has been applied.
+    if (bundleDepth == 0 && ramper) ramper->flushAll();
+
+    if (bundleDepth == 0 && !pendingAcks.isEmpty()) {
+        const double handlerMicros = (Time::getMillisecondCounterHiRes() - bundleStartMs) * 1000.0;
+        for (const auto& id : pendingAcks) sendAck(id, handlerMicros);
+        pendingAcks.clear();
     }
-    selectedMidiClip = nullptr;
-    selectedAudioTrack = nullptr;
-    selectedPlugin = nullptr;
+
+    // A /session/select inside a bundle lasts until the end of that bundle,
+    // so the next bundle (maybe from another client) starts anonymous.
+    anonymousSession.clearSelection();
+    if (bundleDepth == 0) session = &anonymousSession;
+}
+
+void FluidOscServer::handleMessage (const OSCMessage& message) {
+    const double startMs = Time::getMillisecondCounterHiRes();
+    outcome = ServerStats::Outcome::handled;
+    unknownAddress = false;
+    try {
+        dispatchMessage(message);
+    } catch (const OSCFormatError& e) {
+        CYBR_LOG(server, error, "FluidOscServer: Error handling " << message.getAddressPattern().toString() << ": " << e.description);
+        outcome = ServerStats::Outcome::error;
+    } catch (const std::exception& e) {
+        CYBR_LOG(server, error, "FluidOscServer: Exception handling " << message.getAddressPattern().toString() << ": " << e.what());
+        outcome = ServerStats::Outcome::error;
+    }
+    // Addresses come from the network, so unknown ones share one entry.
+    // Otherwise they could fill the table, and real addresses would go
+    // untracked.
+    stats.record(unknownAddress ? String("(unknown)") : message.getAddressPattern().toString(),
+                 outcome, (Time::getMillisecondCounterHiRes() - startMs) * 1000.0);
 }
 
-void FluidOscServer::oscMessageReceived (const OSCMessage& message) {
+void FluidOscServer::dispatchMessage (const OSCMessage& message) {
     const OSCAddressPattern msgAddressPattern = message.getAddressPattern();
 
+    if (msgAddressPattern.matches({"/seq"})) return handleSequenceMessage(message);
+
+    if (msgAddressPattern.toString().startsWith("/stats")) return handleStatsMessage(message);
+
+    if (msgAddressPattern.toString().startsWith("/load/")) return handleLoadMessage(message);
+
+    if (msgAddressPattern.matches({"/reply/port"})) return setReplyTarget(message);
+
+    if (msgAddressPattern.toString().startsWith("/session/")) return handleSessionMessage(message);
+
+    if (msgAddressPattern.matches({"/rebuild/window"})) return setRebuildWindow(message);
+
+    if (msgAddressPattern.toString().startsWith("/edit/")) return handleEditMessage(message);
+
     if (msgAddressPattern.matches({"/test"}) || msgAddressPattern.matches({"/print"})) {
-        printOscMessage(message);
+        CYBR_LOG(server, info, oscMessageToString(message));
         return;
     }
 
-    if (!activeCybrEdit) {
-        std::cout << "NOTE:  message failed , because there is no active CybrEdit: ";
-        printOscMessage(message);
+    if (!session->edit) {
+        CYBR_LOG(server, warn, "NOTE:  message failed , because there is no active CybrEdit: " << oscMessageToString(message));
+        outcome = ServerStats::Outcome::dropped;
         return;
     }
 
     if (msgAddressPattern.matches({"/midiclip/n"})) return insertMidiNote(message);
     if (msgAddressPattern.matches({"/midiclip/select"})) return selectMidiClip(message);
     if (msgAddressPattern.matches({"/midiclip/clear"})) return clearMidiClip(message);
+    if (msgAddressPattern.matches({"/midiclip/replace"})) return replaceMidiNotes(message);
     if (msgAddressPattern.matches({"/plugin/select"})) return selectPlugin(message);
     if (msgAddressPattern.matches({"/plugin/param/set"})) return setPluginParam(message);
+    if (msgAddressPattern.matches({"/plugin/param/ramp"})) return rampPluginParam(message);
+    if (msgAddressPattern.matches({"/plugin/param/automation"})) return writePluginAutomation(message);
     if (msgAddressPattern.matches({"/plugin/save"})) return savePluginPreset(message);
     if (msgAddressPattern.matches({"/plugin/load"})) return loadPluginPreset(message);
+    if (msgAddressPattern.matches({"/plugin/osc/target"})) return setPluginOscTarget(message);
+    if (msgAddressPattern.toString().startsWith({"/plugin/state/"})) return handlePluginStateMessage(message);
     if (msgAddressPattern.matches({"/audiotrack/select"})) return selectAudioTrack(message);
     if (msgAddressPattern.matches({"/save"})) return saveActiveEdit(message);
     if (msgAddressPattern.toString().startsWith({"/transport"})) return handleTransportMessage(message);
+
+    outcome = ServerStats::Outcome::error; // no handler for this address
+    unknownAddress = true;
 }
 
 void FluidOscServer::saveActiveEdit(const juce::OSCMessage &message) {
-    if (!activeCybrEdit) return;
+    if (!session->edit) return;
 
     // If the first argument is string it is a filename
     File file = (message.size() && message[0].isString())
     ? File::getCurrentWorkingDirectory().getChildFile(message[0].getString())
-    : activeCybrEdit->getEdit().editFileRetriever();
+    : session->edit->cybrEdit->getEdit().editFileRetriever();
 
     // By default use relative file paths. If the second arg begins with 'a', use absolute paths
     bool useRelativePaths = true;
@@ -65,14 +227,22 @@ void FluidOscServer::saveActiveEdit(const juce::OSCMessage &message) {
         && message[1].getString().startsWithIgnoreCase({"a"}))
         useRelativePaths = false;
 
-    activeCybrEdit->saveActiveEdit(file, useRelativePaths);
+    // Rendering a .wav takes a while, so do it in the background
+    if (file.hasFileExtension(".wav")) return renderActiveEdit(file);
+    if (ramper) ramper->flush(session->edit->cybrEdit->getEdit());
+    session->edit->cybrEdit->saveActiveEdit(file, useRelativePaths);
 }
 
 void FluidOscServer::selectAudioTrack(const juce::OSCMessage &message) {
     if (!message.size() || !message[0].isString()) return;
 
     String trackName = message[0].getString();
-    selectedAudioTrack = getOrCreateAudioTrackByName(activeCybrEdit->getEdit(), trackName);
+    te::Edit& edit = session->edit->cybrEdit->getEdit();
+    session->selectedAudioTrack = findAudioTrackByName(edit, trackName);
+    if (!session->selectedAudioTrack) {
+        rebuilds.editWillChange(edit);
+        session->selectedAudioTrack = getOrCreateAudioTrackByName(edit, trackName);
+    }
 }
 
 void FluidOscServer::selectPlugin(const OSCMessage& message) {
@@ -83,45 +253,196 @@ void FluidOscServer::selectPlugin(const OSCMessage& message) {
     if (message.size() >= 2 && message[1].isString())
         pluginFormat = message[1].getString();
 
-    if (!selectedAudioTrack) return;
-    selectedPlugin = getOrCreatePluginByName(*selectedAudioTrack, pluginName, pluginFormat);
+    if (!session->selectedAudioTrack) return;
+    session->selectedPlugin = findPluginByName(*session->selectedAudioTrack, pluginName, pluginFormat);
+    if (!session->selectedPlugin) {
+        rebuilds.editWillChange(session->edit->cybrEdit->getEdit());
+        session->selectedPlugin = getOrCreatePluginByName(*session->selectedAudioTrack, pluginName, pluginFormat);
+    }
 }
 
 void FluidOscServer::setPluginParam(const OSCMessage& message) {
-    if (message.size() > 2 ||
+    if (message.size() < 2 ||
         !message[0].isString() ||
         !message[1].isFloat32()) return;
 
-    if (!selectedPlugin) return;
+    if (!session->selectedPlugin) return;
 
     String paramName = message[0].getString();
     float paramValue = message[1].getFloat32();
 
-    for (te::AutomatableParameter* param : selectedPlugin->getAutomatableParameters()) {
-        if (param->paramName.equalsIgnoreCase(paramName)) {
-            param->beginParameterChangeGesture();
-            param->setNormalisedParameter(paramValue, NotificationType::sendNotification); 
-            param->endParameterChangeGesture();
-            std::cout << "set " << paramName << " to " << paramValue << " explicitvalue: " << param->getCurrentExplicitValue() << " value: " << param->getCurrentValue() << std::endl;
-            break;
-        }
+    te::AutomatableParameter* param = getParameterByName(*session->selectedPlugin, paramName);
+    if (!param) return;
+
+    // The ramper applies only the latest value in each audio block (or
+    // message thread tick, for tracktion plugins), and updates the edit at a
+    // fixed rate, however fast values arrive. Handlers that read the edit,
+    // and the end of each bundle, flush it first.
+    if (ramper && ramper->setValue(*session->selectedPlugin, *param, paramValue)) {
+        CYBR_LOG(plugin, trace, "set " << paramName << " to " << paramValue);
+        return;
     }
+    param->beginParameterChangeGesture();
+    param->setNormalisedParameter(paramValue, NotificationType::sendNotification);
+    param->endParameterChangeGesture();
+    CYBR_LOG(plugin, debug, "set " << paramName << " to " << paramValue << " explicitvalue: " << param->getCurrentExplicitValue() << " value: " << param->getCurrentValue());
+}
+
+void FluidOscServer::rampPluginParam(const OSCMessage& message) {
+    if (!session->selectedPlugin) return;
+    if (message.size() < 3 || !message[0].isString() || !message[1].isFloat32()
+        || !(message[2].isFloat32() || message[2].isInt32())) {
+        CYBR_LOG(server, warn, "/plugin/param/ramp expects name (string), target (float), seconds and an optional curve (float)");
+        outcome = ServerStats::Outcome::error;
+        return;
+    }
+    if (!ramper) {
+        CYBR_LOG(server, warn, "/plugin/param/ramp failed, because the server has no engine");
+        return;
+    }
+
+    auto* param = getParameterByName(*session->selectedPlugin, message[0].getString());
+    if (!param) {
+        CYBR_LOG(server, warn, "/plugin/param/ramp failed, because there is no parameter named: " << message[0].getString());
+        outcome = ServerStats::Outcome::error;
+        return;
+    }
+    const double seconds = message[2].isFloat32() ? message[2].getFloat32() : message[2].getInt32();
+    const float curve = (message.size() >= 4 && message[3].isFloat32()) ? message[3].getFloat32() : 0.0f;
+    if (!ramper->startRamp(*session->selectedPlugin, *param, message[1].getFloat32(), seconds, curve)) {
+        CYBR_LOG(server, warn, "/plugin/param/ramp failed, because too many ramps are running");
+        outcome = ServerStats::Outcome::dropped;
+    }
+}
+
+void FluidOscServer::writePluginAutomation(const OSCMessage& message) {
+    if (!session->selectedPlugin) return;
+    if (message.size() < 4 || !message[0].isString() || (message.size() - 1) % 3 != 0) {
+        CYBR_LOG(server, warn, "/plugin/param/automation expects name (string), then groups of three: beat, value and curve");
+        outcome = ServerStats::Outcome::error;
+        return;
+    }
+    auto* param = getParameterByName(*session->selectedPlugin, message[0].getString());
+    if (!param) {
+        CYBR_LOG(server, warn, "/plugin/param/automation failed, because there is no parameter named: " << message[0].getString());
+        outcome = ServerStats::Outcome::error;
+        return;
+    }
+
+    auto number = [](const OSCArgument& arg) -> float {
+        if (arg.isFloat32()) return arg.getFloat32();
+        if (arg.isInt32()) return (float)arg.getInt32();
+        throw OSCFormatError("/plugin/param/automation arguments must be numbers");
+    };
+
+    struct Point { double time; float value, curve; };
+    Array<Point> points;
+    points.ensureStorageAllocated((message.size() - 1) / 3);
+    auto& tempo = session->edit->cybrEdit->getEdit().tempoSequence;
+    for (int i = 1; i < message.size(); i += 3) {
+        const float value = jlimit(0.0f, 1.0f, number(message[i + 1]));
+        points.add({ tempo.beatsToTime(number(message[i])),
+                     param->valueRange.convertFrom0to1(value),
+                     jlimit(-1.0f, 1.0f, number(message[i + 2])) });
+    }
+    std::sort(points.begin(), points.end(), [](const Point& a, const Point& b) { return a.time < b.time; });
+
+    // One message replaces one region of the curve, so a client can rewrite
+    // a bar of automation without clearing the whole curve first.
+    te::AutomationCurve& curve = param->getCurve();
+    curve.removePoints(te::EditTimeRange(points.getFirst().time, points.getLast().time));
+    for (auto& p : points) curve.addPoint(p.time, p.value, p.curve);
+    CYBR_LOG(plugin, debug, "Wrote " << points.size() << " automation points to " << param->paramName);
 }
 
 void FluidOscServer::savePluginPreset(const juce::OSCMessage& message) {
-    if (!selectedPlugin) return;
+    if (!session->selectedPlugin) return;
     if (message.size() < 1 || !message[0].isString()) return;
-    saveTracktionPreset(selectedPlugin, message[0].getString());
+    if (ramper) ramper->flush(session->edit->cybrEdit->getEdit());
+    saveTracktionPreset(session->selectedPlugin, message[0].getString());
+}
+
+void FluidOscServer::setPluginOscTarget(const juce::OSCMessage& message) {
+    auto* ofPlugin = dynamic_cast<OpenFrameworksPlugin*>(session->selectedPlugin);
+    if (!ofPlugin) {
+        CYBR_LOG(server, warn, "Cannot set OSC target: selected plugin is not an OpenFrameworksPlugin");
+        return;
+    }
+    if (message.size() < 2 || !message[0].isString() || !message[1].isInt32()) {
+        CYBR_LOG(server, warn, "Cannot set OSC target: expected hostname (string) and port (int)");
+        return;
+    }
+    ofPlugin->setOscTarget(message[0].getString(), message[1].getInt32());
+    CYBR_LOG(server, info, "Plugin OSC target set to " << message[0].getString() << ":" << message[1].getInt32());
+}
+
+void FluidOscServer::handlePluginStateMessage(const juce::OSCMessage& message) {
+    const String address = message.getAddressPattern().toString();
+    if (!session->selectedPlugin) {
+        CYBR_LOG(server, warn, address << " failed, because no plugin is selected");
+        outcome = ServerStats::Outcome::dropped;
+        return;
+    }
+    // Get must see the latest values, and a waiting value must not overwrite
+    // the state that set restores.
+    if (ramper) ramper->flush(session->edit->cybrEdit->getEdit());
+
+    if (address == "/plugin/state/get") {
+        // Getting the state suspends a live plugin, so only do it if there
+        // is somewhere to send it.
+        if (!hasReplyTarget) {
+            CYBR_LOG(server, warn, "/plugin/state/get failed, because there is no /reply/port target");
+            outcome = ServerStats::Outcome::dropped;
+            return;
+        }
+        const String name = session->selectedPlugin->getName();
+        MemoryBlock state = getPluginState(session->selectedPlugin);
+
+        // The reply is a UDP packet, so it cannot be larger than 64 KB. Tell
+        // the client, instead of leaving it waiting for a reply.
+        String error;
+        if (state.getSize() + (size_t)name.getNumBytesAsUTF8() + 64 > maxUdpReplyBytes)
+            error << "State is " << (int64)state.getSize() << " bytes, which is too large for a UDP reply";
+        else if (!replySender.send({ "/plugin/state" }, OSCArgument(name), OSCArgument(state)))
+            error << "Failed to send " << (int64)state.getSize() << " bytes";
+
+        if (error.isNotEmpty()) {
+            CYBR_LOG(server, warn, "/plugin/state/get failed: " << error);
+            replySender.send({ "/plugin/state/error" }, OSCArgument(name), OSCArgument(error));
+            outcome = ServerStats::Outcome::error;
+        }
+        return;
+    }
+
+    if (address == "/plugin/state/set") {
+        if (message.size() < 1 || !message[0].isBlob()) {
+            CYBR_LOG(server, warn, "/plugin/state/set expects a blob");
+            outcome = ServerStats::Outcome::error;
+            return;
+        }
+        const MemoryBlock& state = message[0].getBlob();
+        // Restoring a tracktion plugin replaces its ValueTree. External
+        // plugins keep their state to themselves.
+        if (!dynamic_cast<te::ExternalPlugin*>(session->selectedPlugin))
+            rebuilds.editWillChange(session->edit->cybrEdit->getEdit());
+        if (!setPluginState(session->selectedPlugin, state.getData(), state.getSize())) {
+            CYBR_LOG(server, warn, "/plugin/state/set failed: " << session->selectedPlugin->getName() << " rejected the state");
+            outcome = ServerStats::Outcome::error;
+        }
+        return;
+    }
+    outcome = ServerStats::Outcome::error;
+    unknownAddress = true;
 }
 
 void FluidOscServer::loadPluginPreset(const juce::OSCMessage& message) {
-    if (!selectedAudioTrack) {
-        std::cout << "Cannot load plugin preset: No audio track selected" << std::endl;
+    if (!session->selectedAudioTrack) {
+        CYBR_LOG(server, warn, "Cannot load plugin preset: No audio track selected");
         return;
     }
 
     if (message.size() < 1 || !message[0].isString()) {
-        std::cout << "Cannot load plugin preset: Message has no preset name" << std::endl;
+        CYBR_LOG(server, warn, "Cannot load plugin preset: Message has no preset name");
         return;
     }
 
@@ -131,9 +452,11 @@ void FluidOscServer::loadPluginPreset(const juce::OSCMessage& message) {
     ValueTree v = loadXmlFile(file);
 
     if (!v.isValid()) {
-        std::cout << "Cannot load plugin preset: Failed to load and parse file" << std::endl;
+        CYBR_LOG(server, warn, "Cannot load plugin preset: Failed to load and parse file");
         return;
     }
+    rebuilds.editWillChange(session->edit->cybrEdit->getEdit());
+    if (ramper) ramper->flush(session->edit->cybrEdit->getEdit());
 
     for (ValueTree preset : v) {
         if (!preset.hasType(te::IDs::PLUGIN)) continue;
@@ -151,13 +474,13 @@ void FluidOscServer::loadPluginPreset(const juce::OSCMessage& message) {
         }
 
         if (name.isEmpty()) {
-            std::cout << "Cannot load plugin preset: plugin has invalid type: " << type << std::endl;
+            CYBR_LOG(server, warn, "Cannot load plugin preset: plugin has invalid type: " << type);
             continue;
         }
 
-        std::cout << "Found preset: " << type << "/" << name << std::endl;
+        CYBR_LOG(server, info, "Found preset: " << type << "/" << name);
 
-        if (te::Plugin* plugin = getOrCreatePluginByName(*selectedAudioTrack, name, type)) {
+        if (te::Plugin* plugin = getOrCreatePluginByName(*session->selectedAudioTrack, name, type)) {
             ValueTree currentConfig = plugin->state;
             // These should be correct on the preset, but just in case, get the ones
             // returned by getOrCreatePluginByName, so we will be sure that we are not
@@ -170,57 +493,63 @@ void FluidOscServer::loadPluginPreset(const juce::OSCMessage& message) {
             if (currentConfig.hasProperty(te::IDs::manufacturer)) preset.setProperty(te::IDs::manufacturer, currentConfig[te::IDs::manufacturer], nullptr);
             if (currentConfig.hasProperty(te::IDs::programNum)) preset.setProperty(te::IDs::programNum, currentConfig[te::IDs::programNum], nullptr);
 
-            std::cout << "Current Config: " << currentConfig.toXmlString() << std::endl;
-            std::cout << "Preset  Config: " << preset.toXmlString() << std::endl;
-            std::cout << "Before loading: " << plugin->state.toXmlString() << std::endl;
+            // The XML is only built when plugin debug logging is on
+            CYBR_LOG(plugin, debug, "Current Config: " << currentConfig.toXmlString());
+            CYBR_LOG(plugin, debug, "Preset  Config: " << preset.toXmlString());
+            CYBR_LOG(plugin, debug, "Before loading: " << plugin->state.toXmlString());
             // Now copy over everything else from the preset. This should inlude the
             // all-important 'state' property of external plugins. External plugins also
             // have some mundane properties like windowLocked="1", enabled="1"
             plugin->restorePluginStateFromValueTree(preset);
 
-            std::cout << "After loading: " << plugin->state.toXmlString() << std::endl;
+            CYBR_LOG(plugin, debug, "After loading: " << plugin->state.toXmlString());
 
-            std::cout
-                << "Track: " << selectedAudioTrack->getName()
-                << " loaded preset: " << file.getFullPathName() << std::endl;
+            CYBR_LOG(server, info, "Track: " << session->selectedAudioTrack->getName()
+                << " loaded preset: " << file.getFullPathName());
         } else {
-            std::cout << "Cannot load plugin preset: failed to create plugin with type/name: " << type << "/" << name << std::endl;
+            CYBR_LOG(server, warn, "Cannot load plugin preset: failed to create plugin with type/name: " << type << "/" << name);
             continue;
         };
     }
 }
 
 void FluidOscServer::selectMidiClip(const juce::OSCMessage &message) {
-    if (!selectedAudioTrack) return;
+    if (!session->selectedAudioTrack) return;
     if (!message.size() || !message[0].isString()) return;
 
     String clipName = message[0].getString();
-    selectedMidiClip = getOrCreateMidiClipByName(*selectedAudioTrack, clipName);
+    session->selectedMidiClip = findMidiClipByName(*session->selectedAudioTrack, clipName);
+    // Creating a clip, or moving one, changes the playback graph
+    if (!session->selectedMidiClip || message.size() >= 2)
+        rebuilds.editWillChange(session->edit->cybrEdit->getEdit());
+    if (!session->selectedMidiClip)
+        session->selectedMidiClip = getOrCreateMidiClipByName(*session->selectedAudioTrack, clipName);
 
     // Clip startBeats
     if (message.size() >= 2 && message[1].isFloat32()) {
         double startBeats = message[1].getFloat32();
-        double startSeconds = activeCybrEdit->getEdit().tempoSequence.beatsToTime(startBeats);
-        selectedMidiClip->setStart(startSeconds, false, true);
+        double startSeconds = session->edit->cybrEdit->getEdit().tempoSequence.beatsToTime(startBeats);
+        session->selectedMidiClip->setStart(startSeconds, false, true);
     }
     // Clip length
     if (message.size() >= 3 && message[2].isFloat32()) {
         double lengthInBeats = message[2].getFloat32();
-        double startBeat = selectedMidiClip->getStartBeat();
+        double startBeat = session->selectedMidiClip->getStartBeat();
         double endBeat = startBeat + lengthInBeats;
-        double endTime = activeCybrEdit->getEdit().tempoSequence.beatsToTime(endBeat);
-        selectedMidiClip->setEnd(endTime, true);
+        double endTime = session->edit->cybrEdit->getEdit().tempoSequence.beatsToTime(endBeat);
+        session->selectedMidiClip->setEnd(endTime, true);
     }
 }
 
 void FluidOscServer::clearMidiClip(const juce::OSCMessage &message) {
-    if (!selectedMidiClip) return;
-    selectedMidiClip->clearTakes();
-    selectedMidiClip->getSequence().clear(nullptr);
+    if (!session->selectedMidiClip) return;
+    rebuilds.editWillChange(session->edit->cybrEdit->getEdit());
+    session->selectedMidiClip->clearTakes();
+    session->selectedMidiClip->getSequence().clear(nullptr);
 }
 
 void FluidOscServer::insertMidiNote(const juce::OSCMessage &message) {
-    if (!selectedMidiClip) return;
+    if (!session->selectedMidiClip) return;
     if (message.size() < 3) return;
 
     for (const auto& arg : message) { if (!arg.isInt32() && !arg.isFloat32()) return; }
@@ -249,20 +578,49 @@ void FluidOscServer::insertMidiNote(const juce::OSCMessage &message) {
         else if (message[4].isFloat32()) colorIndex = (int)(message[4].getFloat32());
     }
 
-    te::MidiList& notes = selectedMidiClip->getSequence();
+    rebuilds.editWillChange(session->edit->cybrEdit->getEdit());
+    te::MidiList& notes = session->selectedMidiClip->getSequence();
     notes.addNote(noteNumber, startBeat, lengthInBeats, velocity, colorIndex, nullptr);
 }
 
+void FluidOscServer::replaceMidiNotes(const juce::OSCMessage &message) {
+    // /midiclip/replace pitch start length velocity [pitch start length velocity ...]
+    if (!session->selectedMidiClip) return;
+    if (message.size() % 4 != 0) {
+        CYBR_LOG(server, warn, "/midiclip/replace expects groups of four: pitch, start, length and velocity");
+        outcome = ServerStats::Outcome::error;
+        return;
+    }
+
+    auto number = [](const OSCArgument& arg) -> double {
+        if (arg.isFloat32()) return arg.getFloat32();
+        if (arg.isInt32()) return arg.getInt32();
+        throw OSCFormatError("/midiclip/replace arguments must be numbers");
+    };
+
+    Array<NoteSpec> notes;
+    notes.ensureStorageAllocated(message.size() / 4);
+    for (int i = 0; i < message.size(); i += 4) {
+        notes.add({ (int)number(message[i]), number(message[i + 1]),
+                    number(message[i + 2]), (int)number(message[i + 3]) });
+    }
+
+    rebuilds.editWillChange(session->edit->cybrEdit->getEdit());
+    NoteDiff diff = ::replaceMidiNotes(session->selectedMidiClip->getSequence(), notes, nullptr);
+    CYBR_LOG(server, debug, "/midiclip/replace added " << diff.added << ", removed " << diff.removed
+        << ", changed " << diff.changed << ", kept " << diff.unchanged);
+}
+
 void FluidOscServer::handleTransportMessage(const OSCMessage& message) {
-    if (!activeCybrEdit) return;
-    te::TransportControl& transport = activeCybrEdit->getEdit().getTransport();
+    if (!session->edit) return;
+    te::TransportControl& transport = session->edit->cybrEdit->getEdit().getTransport();
 
     const OSCAddressPattern pattern = message.getAddressPattern();
     if (pattern.matches({"/transport/play"})) {
-        std::cout << "Play!" << std::endl;
+        CYBR_LOG(server, info, "Play!");
         transport.play(false);
     } else if (pattern.matches({"/transport/stop"})) {
-        std::cout << "Stop!" << std::endl;
+        CYBR_LOG(server, info, "Stop!");
         transport.stop(false, false);
     } else if (pattern.matches({"/transport/to/seconds"})) {
         if (message.size() < 1 || !message[0].isFloat32()) return;
@@ -270,28 +628,28 @@ void FluidOscServer::handleTransportMessage(const OSCMessage& message) {
     } else if (pattern.matches({"/transport/to"})) {
         if (message.size() < 1 || !message[0].isFloat32()) return;
         double beats = message[0].getFloat32();
-        double startSeconds = activeCybrEdit->getEdit().tempoSequence.beatsToTime(beats);
+        double startSeconds = session->edit->cybrEdit->getEdit().tempoSequence.beatsToTime(beats);
         transport.setCurrentPosition(startSeconds);
     } else if (pattern.matches({"/transport/loop"})) {
         if (message.size() < 2 || !message[0].isFloat32() || !message[1].isFloat32()) {
-            std::cout << "/transport/loop failed - requires loop start and duration" << std::endl;
+            CYBR_LOG(server, warn, "/transport/loop failed - requires loop start and duration");
             return;
         }
 
         double startBeats = message[0].getFloat32();
-        double startSeconds = activeCybrEdit->getEdit().tempoSequence.beatsToTime(startBeats);
+        double startSeconds = session->edit->cybrEdit->getEdit().tempoSequence.beatsToTime(startBeats);
         double durationBeats = message[1].getFloat32();
         double endBeats = startBeats + durationBeats;
-        double endSeconds = activeCybrEdit->getEdit().tempoSequence.beatsToTime(endBeats);
+        double endSeconds = session->edit->cybrEdit->getEdit().tempoSequence.beatsToTime(endBeats);
 
         if (durationBeats == 0) {
             // To disable looping specify duration of 0
-            std::cout << "Looping disabled!" << std::endl;
+            CYBR_LOG(server, info, "Looping disabled!");
             transport.looping.setValue(false, nullptr);
             return;
         }
 
-        std::cout << "Looping start|length: " << startBeats << ":" << endBeats << std::endl;
+        CYBR_LOG(server, info, "Looping start|length: " << startBeats << ":" << endBeats);
         transport.setLoopIn(startSeconds);
         transport.setLoopOut(endSeconds);
         // If looping was previously disabled, setting looping to true seems to move the playhead
@@ -300,5 +658,325 @@ void FluidOscServer::handleTransportMessage(const OSCMessage& message) {
         // it probably only changes the playback iff we are not already looping, but if we are looping
         // a different region, playback will be unaffected).
         transport.looping.setValue(true, nullptr);
+    } else {
+        outcome = ServerStats::Outcome::error;
+        unknownAddress = true;
     }
 };
+
+void FluidOscServer::handleLoadMessage(const OSCMessage& message) {
+    const String address = message.getAddressPattern().toString();
+    if (address == "/load/reset") {
+        loadMessagesReceived = 0;
+        loadStartMs = Time::getMillisecondCounterHiRes();
+        CYBR_LOG(server, info, "FluidOscServer: Load test started");
+        return;
+    }
+    if (address != "/load/report") {
+        loadMessagesReceived++;
+        return;
+    }
+
+    if (message.size() < 1 || !message[0].isInt32()) {
+        CYBR_LOG(server, warn, "FluidOscServer: /load/report expects the number of messages sent");
+        return;
+    }
+    int64 sent = message[0].getInt32();
+    int64 dropped = jmax<int64>(0, sent - loadMessagesReceived);
+    double seconds = (Time::getMillisecondCounterHiRes() - loadStartMs) / 1000.0;
+    String rate;
+    if (loadStartMs > 0 && seconds > 0)
+        rate << ". Received " << roundToInt(loadMessagesReceived / seconds) << " msg/s";
+    CYBR_LOG(server, info,
+        "FluidOscServer: Load test received " << loadMessagesReceived << " of " << sent
+        << " messages. Dropped " << dropped
+        << " (" << String(sent > 0 ? 100.0 * dropped / sent : 0.0, 2) << "%)" << rate);
+    loadMessagesReceived = 0;
+    loadStartMs = 0;
+}
+
+void FluidOscServer::setReplyTarget(const OSCMessage& message) {
+    // OSCReceiver does not tell us who sent a message, so clients must tell us
+    // where they want replies.
+    if (message.size() < 1 || !message[0].isInt32()) {
+        CYBR_LOG(server, warn, "/reply/port expects a port (int) and an optional hostname (string)");
+        return;
+    }
+    int port = message[0].getInt32();
+    String host = (message.size() >= 2 && message[1].isString()) ? message[1].getString() : String("127.0.0.1");
+    replySender.disconnect();
+    hasReplyTarget = port > 0 && replySender.connect(host, port);
+    if (hasReplyTarget) CYBR_LOG(server, info, "FluidOscServer: Sending replies to " << host << ":" << port);
+    else CYBR_LOG(server, info, "FluidOscServer: Not sending replies");
+}
+
+void FluidOscServer::handleSequenceMessage(const OSCMessage& message) {
+    if (message.size() < 1 || !(message[0].isInt32() || message[0].isString())) {
+        CYBR_LOG(server, warn, "/seq expects an id (int or string)");
+        return;
+    }
+    if (bundleDepth == 0) {
+        // Values set by earlier standalone messages may still be waiting
+        if (ramper) ramper->flushAll();
+        return sendAck(message[0], 0);
+    }
+    pendingAcks.add(message[0]);
+}
+
+void FluidOscServer::handleStatsMessage(const OSCMessage& message) {
+    const String address = message.getAddressPattern().toString();
+    if (address == "/stats/reset") {
+        stats.reset();
+        return;
+    }
+    if (address == "/stats/push") {
+        int periodMs = (message.size() >= 1 && message[0].isInt32()) ? message[0].getInt32() : 0;
+        if (periodMs > 0) startTimer(jmax(100, periodMs));
+        else stopTimer();
+        return;
+    }
+    if (address == "/stats") {
+        if (hasReplyTarget) stats.sendTo(replySender);
+        else CYBR_LOG(server, info, JSON::toString(stats.toVar(), true));
+        return;
+    }
+    outcome = ServerStats::Outcome::error;
+    unknownAddress = true;
+}
+
+void FluidOscServer::setRebuildWindow(const OSCMessage& message) {
+    if (message.size() >= 1 && message[0].isString() && message[0].getString() == "bar") {
+        rebuilds.setBarAligned(true);
+        CYBR_LOG(server, info, "FluidOscServer: Rebuilding the playback graph at bar lines");
+        return;
+    }
+    if (message.size() < 1 || !(message[0].isInt32() || message[0].isFloat32())) {
+        CYBR_LOG(server, warn, "/rebuild/window expects milliseconds (number) or \"bar\"");
+        outcome = ServerStats::Outcome::error;
+        return;
+    }
+    rebuilds.setBarAligned(false);
+    rebuilds.setWindowMs(message[0].isInt32() ? message[0].getInt32() : roundToInt(message[0].getFloat32()));
+    CYBR_LOG(server, info, "FluidOscServer: Rebuild window set to " << rebuilds.getWindowMs() << "ms");
+}
+
+void FluidOscServer::timerCallback() {
+    if (hasReplyTarget) stats.sendTo(replySender);
+}
+
+void FluidOscServer::sendAck(const OSCArgument& id, double handlerMicros) {
+    if (!hasReplyTarget) return;
+    const int queueDepth = queuedPackets.load() + streamServer.getNumPending();
+    replySender.send({ "/ack" }, id, OSCArgument((float)handlerMicros), OSCArgument(queueDepth));
+}
+
+void FluidOscServer::sendProgress(const String& jobName, float progress) {
+    if (!hasReplyTarget) return;
+    replySender.send({ "/progress" }, OSCArgument(jobName), OSCArgument(progress));
+}
+
+//==============================================================================
+struct FluidOscServer::BackgroundRender {
+    String editName;
+    File file;
+    double startMs = Time::getMillisecondCounterHiRes();
+    // The task refers to the edit, so it must be deleted first
+    std::unique_ptr<te::Edit> edit;
+    std::unique_ptr<te::Renderer::RenderTask> task;
+};
+
+FluidOscServer::HostedEdit* FluidOscServer::findEdit(const String& name) {
+    for (auto* hosted : edits)
+        if (hosted->name == name) return hosted;
+    return nullptr;
+}
+
+void FluidOscServer::setEngine(te::Engine& e) {
+    engine = &e;
+    ramper = std::make_unique<ParameterRamper>(e.getDeviceManager().deviceManager);
+}
+
+void FluidOscServer::addEdit(const String& name, CybrEdit* cybrEdit) {
+    removeEdit(name);
+    auto* hosted = edits.add(new HostedEdit());
+    hosted->name = name;
+    hosted->cybrEdit.reset(cybrEdit);
+    session->edit = hosted;
+    session->clearSelection();
+    CYBR_LOG(server, info, "FluidOscServer: Activated edit: " << name);
+}
+
+bool FluidOscServer::removeEdit(const String& name) {
+    auto* hosted = findEdit(name);
+    if (!hosted) return false;
+    // No session may keep pointers into the edit that we are deleting
+    for (auto* s : sessions) {
+        if (s->edit != hosted) continue;
+        s->edit = nullptr;
+        s->clearSelection();
+    }
+    if (anonymousSession.edit == hosted) {
+        anonymousSession.edit = nullptr;
+        anonymousSession.clearSelection();
+    }
+    rebuilds.flush(hosted->cybrEdit->getEdit());
+    if (ramper) ramper->cancelAll(hosted->cybrEdit->getEdit());
+    edits.removeObject(hosted);
+    return true;
+}
+
+void FluidOscServer::handleEditMessage(const OSCMessage& message) {
+    const String address = message.getAddressPattern().toString();
+    const String name = (message.size() >= 1 && message[0].isString()) ? message[0].getString() : String();
+
+    if (address == "/edit/list") {
+        for (auto* hosted : edits)
+            CYBR_LOG(server, info, (hosted == session->edit ? "* " : "  ") << hosted->name);
+        return;
+    }
+
+    if (address == "/edit/render") {
+        if (!session->edit) {
+            CYBR_LOG(server, warn, "/edit/render failed, because there is no active edit");
+            return;
+        }
+        File file = File::getCurrentWorkingDirectory().getChildFile(name.isNotEmpty() ? name : session->edit->name + ".wav");
+        return renderActiveEdit(file);
+    }
+
+    if (address != "/edit/select" && address != "/edit/remove" && address != "/edit/create") {
+        outcome = ServerStats::Outcome::error;
+        unknownAddress = true;
+        return;
+    }
+
+    if (name.isEmpty()) {
+        CYBR_LOG(server, warn, address << " expects an edit name (string)");
+        return;
+    }
+
+    if (address == "/edit/select") {
+        if (auto* hosted = findEdit(name)) {
+            // Track, clip and plugin selections belong to the previous edit
+            if (session->edit != hosted) session->clearSelection();
+            session->edit = hosted;
+            CYBR_LOG(server, info, "FluidOscServer: Selected edit: " << name);
+        } else {
+            CYBR_LOG(server, warn, "/edit/select failed, because there is no edit named: " << name
+                << ". Use /edit/create to make one");
+            outcome = ServerStats::Outcome::error;
+        }
+        return;
+    }
+
+    if (address == "/edit/remove") {
+        if (removeEdit(name)) {
+            CYBR_LOG(server, info, "FluidOscServer: Removed edit: " << name);
+        } else {
+            CYBR_LOG(server, warn, "/edit/remove failed, because there is no edit named: " << name);
+            outcome = ServerStats::Outcome::error;
+        }
+        return;
+    }
+
+    if (address == "/edit/create") {
+        if (!engine) {
+            CYBR_LOG(server, warn, "/edit/create failed, because the server has no engine");
+            return;
+        }
+        // /edit/create name [file.tracktionedit] loads the file if it exists.
+        // Either way, /save without a filename saves to that file.
+        String filename = (message.size() >= 2 && message[1].isString()) ? message[1].getString() : name + ".tracktionedit";
+        File file = File::getCurrentWorkingDirectory().getChildFile(filename);
+        addEdit(name, loadCybrEditForPlayback(file, *engine));
+        return;
+    }
+}
+
+void FluidOscServer::handleSessionMessage(const OSCMessage& message) {
+    const String address = message.getAddressPattern().toString();
+    String id;
+    if (message.size() >= 1 && message[0].isString()) id = message[0].getString();
+    else if (message.size() >= 1 && message[0].isInt32()) id = String(message[0].getInt32());
+
+    if (address == "/session/select") {
+        // Outside a bundle, nothing would end the selection, and every later
+        // message from every client would use this session.
+        if (bundleDepth == 0) {
+            CYBR_LOG(server, warn, "/session/select must be inside a bundle. Ignoring: " << oscMessageToString(message));
+            outcome = ServerStats::Outcome::error;
+            return;
+        }
+        if (id.isEmpty()) {
+            session = &anonymousSession;
+            return;
+        }
+        for (auto* s : sessions) {
+            if (s->id == id) {
+                session = s;
+                return;
+            }
+        }
+        // A new session starts with the edit that anonymous messages use
+        session = sessions.add(new Session());
+        session->id = id;
+        session->edit = anonymousSession.edit;
+        CYBR_LOG(server, info, "FluidOscServer: New session: " << id);
+        return;
+    }
+
+    if (address == "/session/close") {
+        for (auto* s : sessions) {
+            if (s->id != id) continue;
+            if (session == s) session = &anonymousSession;
+            sessions.removeObject(s);
+            CYBR_LOG(server, info, "FluidOscServer: Closed session: " << id);
+            return;
+        }
+        return;
+    }
+    outcome = ServerStats::Outcome::error;
+    unknownAddress = true;
+}
+
+void FluidOscServer::renderActiveEdit(const File& file) {
+    auto* ui = getUiBehaviour();
+    if (!ui) {
+        CYBR_LOG(server, error, "FluidOscServer: Cannot render without a CliUiBehaviour");
+        return;
+    }
+    // Render a snapshot, so the active edit can keep playing and changing
+    // while the render runs on another thread.
+    auto* render = renders.add(new BackgroundRender());
+    render->editName = session->edit->name;
+    render->file = file;
+    if (ramper) ramper->flush(session->edit->cybrEdit->getEdit());
+    render->edit.reset(copyEditForRendering(session->edit->cybrEdit->getEdit()));
+    // A file left by an earlier render must not look like this one succeeded
+    if (file.existsAsFile() && !file.deleteFile())
+        CYBR_LOG(server, warn, "FluidOscServer: Failed to remove the old render at " << file.getFullPathName());
+    render->task = createRenderTask(*render->edit, file, "Render " + session->edit->name);
+    CYBR_LOG(server, info, "FluidOscServer: Rendering " << render->editName << " to " << file.getFullPathName());
+
+    // The server cancels its renders when it is deleted, so the callback
+    // never outlives it.
+    ui->runTaskAsync(*render->task, [this, render] {
+        const String& error = render->task->errorMessage;
+        const bool ok = error.isEmpty() && render->file.existsAsFile();
+        if (ok) {
+            CYBR_LOG(server, info, "FluidOscServer: Rendered " << render->editName
+                << " in " << (Time::getMillisecondCounterHiRes() - render->startMs) / 1000.0 << " seconds");
+        } else {
+            CYBR_LOG(server, warn, "FluidOscServer: Failed to render " << render->editName
+                << (error.isNotEmpty() ? ": " + error : String()));
+        }
+        if (hasReplyTarget)
+            replySender.send({ "/edit/rendered" }, OSCArgument(render->editName),
+                             OSCArgument(render->file.getFullPathName()), OSCArgument(ok ? 1 : 0));
+        renders.removeObject(render);
+    });
+}
+
+CliUiBehaviour* FluidOscServer::getUiBehaviour() const {
+    return engine ? dynamic_cast<CliUiBehaviour*>(&engine->getUIBehaviour()) : nullptr;
+}
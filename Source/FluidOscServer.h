@@ -13,33 +13,188 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "cybr_helpers.h"
 #include "CybrEdit.h"
+#include "OscStreamServer.h"
+#include "ServerStats.h"
+#include "RebuildCoalescer.h"
+#include "ParameterRamper.h"
+#include "CliUiBehaviour.h"
 
 typedef void (*OscHandlerFunc)(const OSCMessage&);
 
 class FluidOscServer :
     public OSCReceiver,
-    private OSCReceiver::Listener<OSCReceiver::MessageLoopCallback>
+    private OSCReceiver::Listener<OSCReceiver::RealtimeCallback>,
+    private Timer
 {
 public:
     FluidOscServer();
+    ~FluidOscServer();
+    /** Called on the receiver thread. Counts the packet, so that we can report
+     the queue depth, and passes it to the message thread. */
     virtual void oscMessageReceived (const OSCMessage& message) override;
     virtual void oscBundleReceived (const OSCBundle& bundle) override;
 
+    /** Handle a message or a bundle. Call these on the message thread. */
+    void handleMessage(const OSCMessage& message);
+    void handleBundle(const OSCBundle& bundle);
+
     // message handlers
     void selectAudioTrack(const OSCMessage& message);
     void selectMidiClip(const OSCMessage& message);
     void selectPlugin(const OSCMessage& message);
     void setPluginParam(const OSCMessage& message);
+    /** /plugin/param/ramp name target seconds [curve] moves a parameter to a
+     normalised value on the audio thread. See ParameterRamper. */
+    void rampPluginParam(const OSCMessage& message);
+    /** /plugin/param/automation name beat value curve [beat value curve ...]
+     replaces the points between the first and last beat of a parameter's
+     automation curve. Values are normalised. */
+    void writePluginAutomation(const OSCMessage& message);
     void savePluginPreset(const OSCMessage& message);
     void loadPluginPreset(const OSCMessage& message);
+    void setPluginOscTarget(const OSCMessage& message);
+    /** /plugin/state/get replies /plugin/state name blob. /plugin/state/set
+     blob restores it. See getPluginState for what is in the blob. Replies
+     are UDP, so a state that does not fit in one packet gets /plugin/state/error
+     name reason instead. */
+    void handlePluginStateMessage(const OSCMessage& message);
     void clearMidiClip(const OSCMessage& message);
     void insertMidiNote(const OSCMessage& message);
+    void replaceMidiNotes(const OSCMessage& message);
     void saveActiveEdit(const OSCMessage& message);
     void handleTransportMessage(const OSCMessage& message);
-    std::unique_ptr<CybrEdit> activeCybrEdit = nullptr;
+    /** Count messages sent by --osc-load, and print the result on /load/report */
+    void handleLoadMessage(const OSCMessage& message);
+    /** Set where replies (like /progress) are sent: /reply/port port [host] */
+    void setReplyTarget(const OSCMessage& message);
+
+    /** Handle /edit/create, /edit/select, /edit/remove, /edit/list and /edit/render */
+    void handleEditMessage(const OSCMessage& message);
+    /** Handle /session/select id and /session/close id. /session/select is
+     ignored outside a bundle. */
+    void handleSessionMessage(const OSCMessage& message);
+    /** /stats sends the statistics to the reply target (or prints them if
+     there is none). /stats/push periodMs sends them periodically (0 stops).
+     /stats/reset clears them. */
+    void handleStatsMessage(const OSCMessage& message);
+    /** /rebuild/window ms holds structural changes to a playing edit for ms,
+     and rebuilds the playback graph once. /rebuild/window bar holds them until
+     the next bar line. /rebuild/window 0 rebuilds after every change. */
+    void setRebuildWindow(const OSCMessage& message);
+    /** Handle /seq id. In a bundle, the bundle is acknowledged after all of it
+     has been applied. Alone, it is acknowledged at once, which tells the client
+     that every message sent before it has been applied. The acknowledgement,
+     /ack id handlerMicros queueDepth, goes to the /reply/port target. */
+    void handleSequenceMessage(const OSCMessage& message);
+
+    /** Send /progress jobName progress to the reply target, if there is one */
+    void sendProgress(const String& jobName, float progress);
+
+    /** Also accept OSC over TCP, on the same port number. Large bundles that
+     do not fit in a UDP packet can be sent this way. See OscStreamServer. */
+    bool listenForStreams(int port);
+
+    /** The engine that /edit/create uses to make new edits */
+    void setEngine(te::Engine& e);
+
+    /** Host cybrEdit as name, and select it in the current session. The
+     server takes ownership of cybrEdit. An edit with the same name is replaced. */
+    void addEdit(const String& name, CybrEdit* cybrEdit);
+
+    /** The edit that messages in the current session apply to, or nullptr */
+    CybrEdit* getActiveCybrEdit() { return session->edit ? session->edit->cybrEdit.get() : nullptr; }
 
 private:
-    te::AudioTrack* selectedAudioTrack = nullptr;
-    te::MidiClip* selectedMidiClip = nullptr;
-    te::Plugin* selectedPlugin = nullptr;
+    /** An edit hosted by the server. Every hosted edit has its own transport. */
+    struct HostedEdit {
+        String name;
+        std::unique_ptr<CybrEdit> cybrEdit;
+    };
+    HostedEdit* findEdit(const String& name);
+    /** Returns false if there is no edit with that name */
+    bool removeEdit(const String& name);
+    /** Render a copy of the current session's edit in the background, with
+     CliUiBehaviour::runTaskAsync. The message thread is not blocked. */
+    void renderActiveEdit(const File& file);
+    /** The engine's UIBehaviour, which runs our background renders */
+    CliUiBehaviour* getUiBehaviour() const;
+
+    OwnedArray<HostedEdit> edits;
+    te::Engine* engine = nullptr;
+    /** Declared after edits, so it releases its inhibitors before the edits
+     are deleted */
+    RebuildCoalescer rebuilds;
+    /** Created by setEngine, because it needs the engine's audio device */
+    std::unique_ptr<ParameterRamper> ramper;
+
+    /** A session is the selection state of one client: which edit, track,
+     clip and plugin its messages apply to. Clients that share a server
+     should each begin their bundles with /session/select id, so that
+     interleaved bundles from different clients cannot change each other's
+     targets. A named session keeps its selection between bundles. Only the
+     rest of the bundle uses it, so /session/select alone does nothing.
+
+     Messages without a session use the anonymous session, which works like
+     the server always has: its track, clip and plugin are forgotten at the
+     end of every bundle. */
+    struct Session {
+        String id;
+        HostedEdit* edit = nullptr;
+        te::AudioTrack* selectedAudioTrack = nullptr;
+        te::MidiClip* selectedMidiClip = nullptr;
+        te::Plugin* selectedPlugin = nullptr;
+
+        void clearSelection() {
+            selectedAudioTrack = nullptr;
+            selectedMidiClip = nullptr;
+            selectedPlugin = nullptr;
+        }
+    };
+    Session anonymousSession;
+    OwnedArray<Session> sessions;
+    /** The session that messages apply to. Never nullptr. */
+    Session* session = &anonymousSession;
+    int bundleDepth = 0;
+
+    struct BackgroundRender;
+    OwnedArray<BackgroundRender> renders;
+
+    OSCSender replySender;
+    /** The largest UDP payload that a reply can have */
+    static constexpr size_t maxUdpReplyBytes = 65507;
+    bool hasReplyTarget = false;
+    OscStreamServer streamServer;
+
+    /** Find the handler for a message and call it */
+    void dispatchMessage(const OSCMessage& message);
+    void timerCallback() override;
+    ServerStats stats;
+    /** dispatchMessage sets this when a message is not handled */
+    ServerStats::Outcome outcome = ServerStats::Outcome::handled;
+    /** Set with outcome when no handler knows the address */
+    bool unknownAddress = false;
+
+    /** Send /ack id handlerMicros queueDepth to the reply target */
+    void sendAck(const OSCArgument& id, double handlerMicros);
+    /** UDP packets that were received, but not handled yet */
+    std::atomic<int> queuedPackets { 0 };
+
+    /** Called on the receiver thread. If the message is a /plugin/param/set
+     that can join the batch waiting for the message thread, add it (or
+     replace the older value for the same parameter) and return true, so a
+     controller that floods the server costs one message thread callback per
+     batch. Anything else closes the batch. */
+    bool coalesceParamSet(const OSCMessage& message);
+    struct ParamSetBatch;
+    std::shared_ptr<ParamSetBatch> openParamSetBatch; // receiver thread only
+    WeakReference<FluidOscServer> weakThis;
+    /** /seq ids from the current top level bundle, acked when it ends. A
+     bundle (or its nested bundles) may carry more than one. */
+    Array<OSCArgument> pendingAcks;
+    double bundleStartMs = 0;
+
+    int64 loadMessagesReceived = 0;
+    double loadStartMs = 0;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(FluidOscServer)
 };
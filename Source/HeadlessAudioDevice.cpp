@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    HeadlessAudioDevice.cpp
+    Created: 18 Oct 2026 8:26:40pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "HeadlessAudioDevice.h"
+
+HeadlessAudioIODevice::HeadlessAudioIODevice(const String& name, double s) :
+    AudioIODevice(name, HeadlessAudioIODeviceType::typeName),
+    Thread("Headless Audio"),
+    speed(s)
+{
+}
+
+HeadlessAudioIODevice::~HeadlessAudioIODevice()
+{
+    close();
+}
+
+String HeadlessAudioIODevice::open(const BigInteger& inputChannels, const BigInteger& outputChannels,
+                                   double newSampleRate, int newBufferSize)
+{
+    close();
+    sampleRate = newSampleRate > 0 ? newSampleRate : 44100.0;
+    bufferSize = newBufferSize > 0 ? newBufferSize : getDefaultBufferSize();
+
+    activeInputs = inputChannels;
+    activeInputs.setRange(2, activeInputs.getHighestBit() + 1, false);
+    activeOutputs = outputChannels;
+    activeOutputs.setRange(2, activeOutputs.getHighestBit() + 1, false);
+
+    inputBuffer.setSize(jmax(1, activeInputs.countNumberOfSetBits()), bufferSize);
+    outputBuffer.setSize(jmax(1, activeOutputs.countNumberOfSetBits()), bufferSize);
+    inputBuffer.clear();
+    deviceIsOpen = true;
+    return {};
+}
+
+void HeadlessAudioIODevice::close()
+{
+    stop();
+    deviceIsOpen = false;
+}
+
+void HeadlessAudioIODevice::start(AudioIODeviceCallback* newCallback)
+{
+    if (!deviceIsOpen || newCallback == nullptr) return;
+    stop();
+    newCallback->audioDeviceAboutToStart(this);
+    {
+        const ScopedLock sl (callbackLock);
+        callback = newCallback;
+    }
+    startThread(8);
+}
+
+void HeadlessAudioIODevice::stop()
+{
+    stopThread(2000);
+    AudioIODeviceCallback* oldCallback;
+    {
+        const ScopedLock sl (callbackLock);
+        oldCallback = callback;
+        callback = nullptr;
+    }
+    if (oldCallback != nullptr) oldCallback->audioDeviceStopped();
+}
+
+void HeadlessAudioIODevice::run()
+{
+    const double blockMs = 1000.0 * bufferSize / sampleRate;
+    double dueMs = Time::getMillisecondCounterHiRes();
+
+    while (!threadShouldExit()) {
+        {
+            const ScopedLock sl (callbackLock);
+            if (callback != nullptr)
+                callback->audioDeviceIOCallback(inputBuffer.getArrayOfReadPointers(),
+                                                activeInputs.countNumberOfSetBits(),
+                                                outputBuffer.getArrayOfWritePointers(),
+                                                activeOutputs.countNumberOfSetBits(),
+                                                bufferSize);
+        }
+
+        if (speed <= 0) {
+            // Let other threads (like the message thread) have a turn, so a
+            // run that is as fast as possible does not starve them.
+            Thread::yield();
+            continue;
+        }
+
+        // Schedule against the start time, so small sleep errors do not add up
+        dueMs += blockMs / speed;
+        const double nowMs = Time::getMillisecondCounterHiRes();
+        if (dueMs > nowMs) wait((int)std::ceil(dueMs - nowMs));
+        else if (nowMs - dueMs > 1000.0) dueMs = nowMs; // we fell far behind
+    }
+}
+
+//==============================================================================
+HeadlessAudioIODeviceType::HeadlessAudioIODeviceType(double s) :
+    AudioIODeviceType(typeName),
+    speed(s)
+{
+}
+
+AudioIODevice* HeadlessAudioIODeviceType::createDevice(const String&, const String&)
+{
+    return new HeadlessAudioIODevice(deviceName, speed);
+}
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    HeadlessAudioDevice.h
+    Created: 18 Oct 2026 8:26:40pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <iostream>
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** HeadlessAudioIODevice is an audio device with no hardware. A thread pulls
+ the audio callback, either in step with the wall clock times a speed multiple,
+ or as fast as possible. Output is discarded, and input is silent.
+
+ This lets us play and record on machines without a sound card, and lets
+ tests run faster than realtime.
+ */
+class HeadlessAudioIODevice :
+    public AudioIODevice,
+    private Thread
+{
+public:
+    /** A speed of 1 runs in realtime. 0 or less runs as fast as possible. */
+    HeadlessAudioIODevice(const String& deviceName, double speed);
+    ~HeadlessAudioIODevice();
+
+    StringArray getOutputChannelNames() override { return { "Left", "Right" }; }
+    StringArray getInputChannelNames() override { return { "Left", "Right" }; }
+    Array<double> getAvailableSampleRates() override { return { 44100.0, 48000.0, 88200.0, 96000.0 }; }
+    Array<int> getAvailableBufferSizes() override { return { 64, 128, 256, 512, 1024, 2048 }; }
+    int getDefaultBufferSize() override { return 512; }
+
+    String open(const BigInteger& inputChannels, const BigInteger& outputChannels,
+                double sampleRate, int bufferSizeSamples) override;
+    void close() override;
+    bool isOpen() override { return deviceIsOpen; }
+    void start(AudioIODeviceCallback* callback) override;
+    void stop() override;
+    bool isPlaying() override { return isThreadRunning(); }
+    String getLastError() override { return {}; }
+
+    int getCurrentBufferSizeSamples() override { return bufferSize; }
+    double getCurrentSampleRate() override { return sampleRate; }
+    int getCurrentBitDepth() override { return 32; }
+    BigInteger getActiveOutputChannels() const override { return activeOutputs; }
+    BigInteger getActiveInputChannels() const override { return activeInputs; }
+    int getOutputLatencyInSamples() override { return 0; }
+    int getInputLatencyInSamples() override { return 0; }
+
+private:
+    void run() override;
+
+    double speed;
+    double sampleRate = 44100.0;
+    int bufferSize = 512;
+    bool deviceIsOpen = false;
+    BigInteger activeInputs, activeOutputs;
+    AudioBuffer<float> inputBuffer, outputBuffer;
+
+    CriticalSection callbackLock;
+    AudioIODeviceCallback* callback = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE(HeadlessAudioIODevice)
+};
+
+/** Add this to the engine's juce::AudioDeviceManager to make the headless
+ device available. */
+class HeadlessAudioIODeviceType : public AudioIODeviceType {
+public:
+    static constexpr const char* typeName = "Headless";
+    static constexpr const char* deviceName = "Headless Audio";
+
+    HeadlessAudioIODeviceType(double speed);
+
+    /** The speed of devices created from now on. A device that is already
+     open keeps its speed until it is reopened. */
+    void setSpeed(double newSpeed) { speed = newSpeed; }
+
+    void scanForDevices() override {}
+    StringArray getDeviceNames(bool) const override { return { deviceName }; }
+    int getDefaultDeviceIndex(bool) const override { return 0; }
+    int getIndexOfDevice(AudioIODevice* device, bool) const override { return device != nullptr ? 0 : -1; }
+    bool hasSeparateInputsAndOutputs() const override { return false; }
+    AudioIODevice* createDevice(const String& outputDeviceName, const String& inputDeviceName) override;
+
+private:
+    double speed;
+};
@@ -0,0 +1,223 @@
+/*
+  ==============================================================================
+
+    LoudnessAnalyser.cpp
+    Created: 18 Oct 2026 7:02:54pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "LoudnessAnalyser.h"
+
+static double toDb(double gain) { return gain > 0 ? 20.0 * std::log10(gain) : -std::numeric_limits<double>::infinity(); }
+static var dbOrNull(double db) { return std::isfinite(db) ? var(db) : var(); }
+
+/** BS.1770 channel weights. Left, right and center are 1. Surround channels
+ are 1.41 (+1.5dB) */
+static double channelWeight(int channel) { return channel < 3 ? 1.0 : 1.41; }
+
+var LoudnessAnalyser::Results::toVar() const
+{
+    auto* obj = new DynamicObject();
+    var result(obj);
+    obj->setProperty("integratedLufs", dbOrNull(integratedLufs));
+    obj->setProperty("truePeakDb", dbOrNull(truePeakDb));
+    obj->setProperty("samplePeakDb", dbOrNull(samplePeakDb));
+    obj->setProperty("rmsDb", dbOrNull(rmsDb));
+    obj->setProperty("clippedSamples", clippedSamples);
+    obj->setProperty("numSamples", numSamples);
+    return result;
+}
+
+void LoudnessAnalyser::prepare(double rate, int channels, int blockSize, double expectedSeconds)
+{
+    sampleRate = rate;
+    numChannels = jmax(1, channels);
+    maxBlockSize = jmax(1, blockSize);
+
+    // K-weighting filter coefficients for any sample rate. These are derived
+    // from the 48kHz coefficients in BS.1770 (this is how libebur128 does it).
+    {
+        const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+        const double k = std::tan(MathConstants<double>::pi * f0 / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        shelf.b1 = 2.0 * (k * k - vh) / a0;
+        shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf.a2 = (1.0 - k / q + k * k) / a0;
+    }
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        const double k = std::tan(MathConstants<double>::pi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+        highPass.b0 = 1.0;
+        highPass.b1 = -2.0;
+        highPass.b2 = 1.0;
+        highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPass.a2 = (1.0 - k / q + k * k) / a0;
+    }
+    shelfStates.assign((size_t)numChannels, {});
+    highPassStates.assign((size_t)numChannels, {});
+
+    hopSize = jmax(1, roundToInt(sampleRate * 0.1));
+    samplesInCurrentHop = 0;
+    currentHopSums.assign((size_t)numChannels, 0.0);
+    hopEnergies.clear();
+    hopEnergies.reserve((size_t)(jmax(0.0, expectedSeconds) * 10.0) + 64);
+
+    // 2 stages of 2x gives the 4x oversampling that BS.1770 asks for
+    oversampler = std::make_unique<dsp::Oversampling<float>>((size_t)numChannels, 2,
+        dsp::Oversampling<float>::filterHalfBandFIREquiripple, true);
+    oversampler->initProcessing((size_t)maxBlockSize);
+    oversampler->reset();
+
+    sumOfSquares = 0;
+    samplePeak = 0;
+    truePeak = 0;
+    clippedSamples = 0;
+    numSamples = 0;
+    numChannelSamples = 0;
+}
+
+void LoudnessAnalyser::process(AudioBuffer<float>& buffer, int startSample, int count)
+{
+    if (!isPrepared() || count <= 0) return;
+    const int channels = jmin(numChannels, buffer.getNumChannels());
+
+    for (int ch = 0; ch < channels; ch++) {
+        const float* samples = buffer.getReadPointer(ch, startSample);
+
+        auto range = FloatVectorOperations::findMinAndMax(samples, count);
+        samplePeak = jmax(samplePeak, std::abs(range.getStart()), std::abs(range.getEnd()));
+
+        // Four independent accumulators let the compiler keep several lanes
+        // in flight, instead of waiting on a single running sum.
+        double sums[4] = { 0, 0, 0, 0 };
+        int64 clipped = 0;
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            for (int lane = 0; lane < 4; lane++) {
+                const float x = samples[i + lane];
+                sums[lane] += (double)x * x;
+                clipped += std::abs(x) >= 1.0f;
+            }
+        }
+        for (; i < count; i++) {
+            sums[0] += (double)samples[i] * samples[i];
+            clipped += std::abs(samples[i]) >= 1.0f;
+        }
+        sumOfSquares += sums[0] + sums[1] + sums[2] + sums[3];
+        clippedSamples += clipped;
+    }
+    numSamples += count;
+    numChannelSamples += (int64)count * channels;
+
+    // Split the block at the 100ms hop boundaries
+    int done = 0;
+    while (done < count) {
+        const int length = jmin(count - done, hopSize - samplesInCurrentHop);
+        for (int ch = 0; ch < channels; ch++)
+            processKWeighted(ch, buffer.getReadPointer(ch, startSample + done), length);
+        samplesInCurrentHop += length;
+        done += length;
+
+        if (samplesInCurrentHop == hopSize) {
+            double energy = 0;
+            for (int ch = 0; ch < numChannels; ch++) {
+                energy += channelWeight(ch) * currentHopSums[(size_t)ch] / hopSize;
+                currentHopSums[(size_t)ch] = 0;
+            }
+            if (hopEnergies.size() < hopEnergies.capacity()) hopEnergies.push_back(energy);
+            samplesInCurrentHop = 0;
+        }
+    }
+
+    measureTruePeak(buffer, startSample, count);
+}
+
+void LoudnessAnalyser::processKWeighted(int channel, const float* samples, int count)
+{
+    FilterState s1 = shelfStates[(size_t)channel];
+    FilterState s2 = highPassStates[(size_t)channel];
+    double sum = 0;
+    for (int i = 0; i < count; i++) {
+        // Transposed direct form II
+        const double x = samples[i];
+        const double y1 = shelf.b0 * x + s1.z1;
+        s1.z1 = shelf.b1 * x - shelf.a1 * y1 + s1.z2;
+        s1.z2 = shelf.b2 * x - shelf.a2 * y1;
+        const double y2 = highPass.b0 * y1 + s2.z1;
+        s2.z1 = highPass.b1 * y1 - highPass.a1 * y2 + s2.z2;
+        s2.z2 = highPass.b2 * y1 - highPass.a2 * y2;
+        sum += y2 * y2;
+    }
+    shelfStates[(size_t)channel] = s1;
+    highPassStates[(size_t)channel] = s2;
+    currentHopSums[(size_t)channel] += sum;
+}
+
+void LoudnessAnalyser::measureTruePeak(AudioBuffer<float>& buffer, int startSample, int count)
+{
+    // A buffer with fewer channels than we prepared for is measured on the
+    // channels it has.
+    const size_t channels = (size_t)jmin(numChannels, buffer.getNumChannels());
+    if (channels == 0) return;
+    dsp::AudioBlock<float> block(buffer.getArrayOfWritePointers(), channels, (size_t)startSample, (size_t)count);
+
+    // The oversampler can only take maxBlockSize samples at a time. It does
+    // not change its input, so the audio passing through is untouched.
+    for (size_t done = 0; done < (size_t)count; done += (size_t)maxBlockSize) {
+        auto chunk = block.getSubBlock(done, jmin((size_t)maxBlockSize, (size_t)count - done));
+        auto up = oversampler->processSamplesUp(chunk);
+        for (size_t ch = 0; ch < jmin(channels, up.getNumChannels()); ch++) {
+            auto range = FloatVectorOperations::findMinAndMax(up.getChannelPointer(ch), (int)up.getNumSamples());
+            truePeak = jmax(truePeak, std::abs(range.getStart()), std::abs(range.getEnd()));
+        }
+    }
+}
+
+LoudnessAnalyser::Results LoudnessAnalyser::getResults() const
+{
+    Results r;
+    r.numSamples = numSamples;
+    r.clippedSamples = clippedSamples;
+    r.samplePeakDb = toDb(samplePeak);
+    // The oversampling filters can undershoot a little, so the true peak is
+    // never reported below the sample peak.
+    r.truePeakDb = toDb(jmax(truePeak, samplePeak));
+    if (numChannelSamples > 0)
+        r.rmsDb = toDb(std::sqrt(sumOfSquares / (double)numChannelSamples));
+
+    // Each 400ms gating block is four consecutive 100ms hops
+    auto loudness = [] (double energy) { return -0.691 + 10.0 * std::log10(energy); };
+    const int numBlocks = (int)hopEnergies.size() - 3;
+    if (numBlocks <= 0) return r;
+
+    auto blockEnergy = [this] (int b) {
+        return (hopEnergies[(size_t)b] + hopEnergies[(size_t)b + 1] + hopEnergies[(size_t)b + 2] + hopEnergies[(size_t)b + 3]) * 0.25;
+    };
+
+    // Absolute gate at -70 LUFS
+    double sum = 0;
+    int n = 0;
+    for (int b = 0; b < numBlocks; b++) {
+        double e = blockEnergy(b);
+        if (e > 0 && loudness(e) > -70.0) { sum += e; n++; }
+    }
+    if (n == 0) return r;
+
+    // Relative gate 10 LU below the loudness of the blocks that passed
+    const double relativeGate = loudness(sum / n) - 10.0;
+    sum = 0;
+    n = 0;
+    for (int b = 0; b < numBlocks; b++) {
+        double e = blockEnergy(b);
+        if (e > 0 && loudness(e) > -70.0 && loudness(e) > relativeGate) { sum += e; n++; }
+    }
+    if (n > 0) r.integratedLufs = loudness(sum / n);
+    return r;
+}
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    LoudnessAnalyser.h
+    Created: 18 Oct 2026 7:02:54pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** LoudnessAnalyser measures a stream of audio, one block at a time:
+ - Integrated loudness in LUFS, as described in ITU-R BS.1770-4 (K-weighting,
+   400ms blocks with 75% overlap, and the absolute and relative gates)
+ - True peak, from 4x oversampled audio
+ - Sample peak, RMS, and the number of samples at or above full scale
+
+ Call prepare before processing. process does not allocate, so it is safe to
+ call from a render or mixer thread.
+ */
+class LoudnessAnalyser {
+public:
+    struct Results {
+        double integratedLufs = -std::numeric_limits<double>::infinity();
+        double truePeakDb = -std::numeric_limits<double>::infinity();
+        double samplePeakDb = -std::numeric_limits<double>::infinity();
+        double rmsDb = -std::numeric_limits<double>::infinity();
+        int64 clippedSamples = 0;
+        int64 numSamples = 0;
+
+        /** A JSON object. Values of -inf are written as null */
+        var toVar() const;
+    };
+
+    /** Allocate everything that process needs. expectedSeconds is only used
+     to size the loudness history. Audio past that is measured for peaks and
+     RMS, but not for loudness. */
+    void prepare(double sampleRate, int numChannels, int maxBlockSize, double expectedSeconds);
+
+    /** Measure a block. Channels beyond those passed to prepare are ignored */
+    void process(AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    Results getResults() const;
+
+    bool isPrepared() const { return oversampler != nullptr; }
+
+private:
+    struct Biquad {
+        double b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+    };
+    struct FilterState {
+        double z1 = 0, z2 = 0;
+    };
+
+    void processKWeighted(int channel, const float* samples, int numSamples);
+    void measureTruePeak(AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    double sampleRate = 0;
+    int numChannels = 0;
+    int maxBlockSize = 0;
+
+    Biquad shelf, highPass;
+    std::vector<FilterState> shelfStates, highPassStates;
+
+    /** Mean square of the K-weighted signal (summed across channels with the
+     BS.1770 channel weights) for each 100ms hop */
+    std::vector<double> hopEnergies;
+    std::vector<double> currentHopSums;
+    int hopSize = 0;
+    int samplesInCurrentHop = 0;
+
+    std::unique_ptr<dsp::Oversampling<float>> oversampler;
+
+    double sumOfSquares = 0;
+    float samplePeak = 0;
+    float truePeak = 0;
+    int64 clippedSamples = 0;
+    int64 numSamples = 0;
+    /** Samples that went into sumOfSquares, counted on every channel */
+    int64 numChannelSamples = 0;
+};
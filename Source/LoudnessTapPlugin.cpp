@@ -0,0 +1,43 @@
+/*
+  ==============================================================================
+
+    LoudnessTapPlugin.cpp
+    Created: 18 Oct 2026 7:31:16pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "LoudnessTapPlugin.h"
+
+const char* LoudnessTapPlugin::xmlTypeName = "cybrloudnesstap";
+
+LoudnessTapPlugin::LoudnessTapPlugin(te::PluginCreationInfo info) : te::Plugin(info)
+{
+}
+
+LoudnessTapPlugin::~LoudnessTapPlugin()
+{
+    notifyListenersOfDeletion();
+}
+
+ValueTree LoudnessTapPlugin::create()
+{
+    ValueTree v (te::IDs::PLUGIN);
+    v.setProperty (te::IDs::type, xmlTypeName, nullptr);
+    return v;
+}
+
+void LoudnessTapPlugin::initialise(const te::PlaybackInitialisationInfo& info)
+{
+    // This happens before rendering starts, so it is fine to allocate here
+    analyser.prepare(info.sampleRate, 2, info.blockSizeSamples, edit.getLength() + 1.0);
+}
+
+// Called from a "mixer" thread. Taps on different tracks may run at the same
+// time, but each tap only touches its own analyser.
+void LoudnessTapPlugin::applyToBuffer(const te::AudioRenderContext& fc)
+{
+    if (fc.destBuffer == nullptr) return;
+    analyser.process(*fc.destBuffer, fc.bufferStartSample, fc.bufferNumSamples);
+}
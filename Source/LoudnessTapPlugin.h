@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    LoudnessTapPlugin.h
+    Created: 18 Oct 2026 7:31:16pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <iostream>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "LoudnessAnalyser.h"
+
+namespace te = tracktion_engine;
+
+/** LoudnessTapPlugin passes audio through unchanged, and measures it with a
+ LoudnessAnalyser. EditAnalysis inserts one at the end of each track, and on
+ the master plugin list, so that a single render measures every track and the
+ mix at once. Like OpenFrameworksPlugin, it must be registered with
+ PluginManager::createBuiltInType before it can be created.
+ */
+class LoudnessTapPlugin : public te::Plugin
+{
+public:
+    LoudnessTapPlugin(te::PluginCreationInfo);
+    ~LoudnessTapPlugin();
+    static ValueTree create();
+
+    static const char* getPluginName() { return NEEDS_TRANS("Loudness Tap"); }
+    static const char* xmlTypeName;
+
+    juce::String getName() override { return TRANS("Loudness Tap"); }
+    juce::String getPluginType() override { return xmlTypeName; }
+    juce::String getShortName(int) override { return "LTap"; }
+
+    void initialise(const te::PlaybackInitialisationInfo&) override;
+    void deinitialise() override { }
+    double getLatencySeconds() override { return 0.0; }
+    int getNumOutputChannelsGivenInputs(int numInputChannels) override { return jmin(numInputChannels, 2); }
+    void getChannelNames(juce::StringArray*, juce::StringArray*) override {}
+    bool isSynth() override { return false; }
+    bool takesAudioInput() override { return true; }
+    bool canBeAddedToClip() override { return false; }
+    bool needsConstantBufferSize() override { return false; }
+
+    void applyToBuffer(const te::AudioRenderContext&) override;
+
+    juce::String getSelectableDescription() override { return TRANS("Loudness Tap Plugin"); }
+
+    /** Call after rendering has finished */
+    LoudnessAnalyser::Results getResults() const { return analyser.getResults(); }
+
+private:
+    LoudnessAnalyser analyser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessTapPlugin)
+};
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    MidiOscSender.cpp
+    Created: 18 Oct 2026 6:20:31pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "MidiOscSender.h"
+
+MidiOscSender::MidiOscSender() : Thread("MIDI OSC Sender")
+{
+    pending.reserve(4096);
+}
+
+MidiOscSender::~MidiOscSender()
+{
+    stopThread(1000);
+}
+
+void MidiOscSender::setTarget(const String& hostname, int port)
+{
+    const ScopedLock sl (senderLock);
+    sender.disconnect();
+    bool connected = port > 0 && sender.connect(hostname, port);
+    if (port > 0 && !connected)
+        std::cerr << "MidiOscSender: Failed to connect to " << hostname << ":" << port << std::endl;
+    enabled = connected;
+    if (connected && !isThreadRunning()) startThread(7);
+}
+
+void MidiOscSender::run()
+{
+    while (!threadShouldExit()) {
+        sendPending();
+        wait(2);
+    }
+}
+
+void MidiOscSender::sendPending()
+{
+    pending.clear();
+    queue.readInto(pending);
+    if (pending.empty()) return;
+
+    // Host time and wall clock time advance together, so one offset converts
+    // every event in this batch.
+    const double wallClockOffsetMs = (double)Time::currentTimeMillis() - Time::getMillisecondCounterHiRes();
+
+    const ScopedLock sl (senderLock);
+    if (!enabled) return;
+
+    size_t i = 0;
+    while (i < pending.size()) {
+        // Events from the same audio block share a host time
+        const double blockTime = pending[i].arrivedAt;
+        OSCBundle bundle(OSCTimeTag(Time((int64)(blockTime * 1000.0 + wallClockOffsetMs))));
+        int numInBundle = 0;
+        while (i < pending.size() && pending[i].arrivedAt == blockTime && numInBundle < maxMessagesPerBundle) {
+            const MidiMessage& m = pending[i].message;
+            const uint8* data = m.getRawData();
+            int size = m.getRawDataSize();
+            bundle.addElement(OSCMessage({ "/midi" },
+                                         (float)pending[i].editTime,
+                                         (int32)(size > 0 ? data[0] : 0),
+                                         (int32)(size > 1 ? data[1] : 0),
+                                         (int32)(size > 2 ? data[2] : 0)));
+            numInBundle++;
+            i++;
+        }
+        sender.send(bundle);
+    }
+}
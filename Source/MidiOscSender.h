@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    MidiOscSender.h
+    Created: 18 Oct 2026 6:20:31pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <iostream>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "TimestampedTest.h"
+
+/** MidiOscSender forwards MIDI from the audio thread to an OSC receiver, such
+ as our openFrameworks visuals, without the audio thread touching the network.
+
+ The audio thread pushes events into a lock free queue. A dedicated thread
+ drains the queue every couple of milliseconds, and sends the events from each
+ audio block as an OSC bundle:
+    /midi editTime status data1 data2
+ The bundle's timetag is the wall clock time at which the block will be heard
+ (after the output latency), so a receiver can schedule the events to line up
+ with the audio. editTime is in seconds.
+ */
+class MidiOscSender : private Thread {
+public:
+    MidiOscSender();
+    ~MidiOscSender();
+
+    /** Set where to send. A port of 0 or less stops sending. Call this on the
+     message thread. */
+    void setTarget(const String& hostname, int port);
+
+    /** Queue an event. Call this on the audio thread. `arrivedAt` should be
+     the host time (Time::getMillisecondCounterHiRes in seconds) at which the
+     event will be heard. */
+    void push(const TimestampedMidi& event)
+    {
+        if (enabled.load(std::memory_order_relaxed)) queue.writeMessage(event);
+    }
+
+    bool isEnabled() const { return enabled; }
+
+private:
+    void run() override;
+    void sendPending();
+
+    LockFreeQueue<TimestampedMidi> queue;
+    std::vector<TimestampedMidi> pending;
+    std::atomic<bool> enabled { false };
+
+    /** Held by the sending thread while it sends, and by setTarget */
+    CriticalSection senderLock;
+    OSCSender sender;
+
+    static constexpr int maxMessagesPerBundle = 32;
+
+    JUCE_DECLARE_NON_COPYABLE(MidiOscSender)
+};
@@ -9,6 +9,10 @@
 */
 
 #include "OpenFrameworksPlugin.h"
+#include "RealtimeLog.h"
+
+static const Identifier oscHostId("oscHost");
+static const Identifier oscPortId("oscPort");
 
 OpenFrameworksPlugin::OpenFrameworksPlugin(te::PluginCreationInfo info) : te::Plugin(info)
 {
@@ -25,6 +29,10 @@ OpenFrameworksPlugin::OpenFrameworksPlugin(te::PluginCreationInfo info) : te::Pl
 
     semitonesValue.referTo(state, te::IDs::semitonesUp, getUndoManager());
     semitones->attachToCurrentValue(semitonesValue);
+
+    oscHost.referTo(state, oscHostId, getUndoManager(), "127.0.0.1");
+    oscPort.referTo(state, oscPortId, getUndoManager(), 0);
+    oscSender.setTarget(oscHost, oscPort);
 }
 
 OpenFrameworksPlugin::~OpenFrameworksPlugin()
@@ -48,15 +56,28 @@ void OpenFrameworksPlugin::applyToBuffer(const te::AudioRenderContext& fc)
 {
     if (fc.bufferForMidiMessages != nullptr) {
         fc.bufferForMidiMessages->addToNoteNumbers(roundToInt(semitones->getCurrentValue()));
+
+        if (oscSender.isEnabled() && !fc.bufferForMidiMessages->isEmpty()) {
+            // Message time stamps are seconds from the start of the block,
+            // offset by midiBufferOffset. Events are stamped with the host
+            // time at which they will come out of the speakers.
+            const double blockEditTime = fc.playhead.streamTimeToSourceTime(fc.streamTime.start);
+            const double heardAt = Time::getMillisecondCounterHiRes() * 0.001
+                + engine.getDeviceManager().getOutputLatencySeconds();
+            for (auto& msg : *(fc.bufferForMidiMessages)) {
+                const double offset = msg.getTimeStamp() - fc.midiBufferOffset;
+                oscSender.push({ heardAt, fc.streamTime.start + offset, blockEditTime + offset, msg });
+            }
+        }
+
+        // Printing with std::cout here would lock and make system calls on
+        // the mixer thread, so write to the realtime log instead. The values
+        // are the block's stream time, and the message's time stamp within
+        // the block (which is not really meaningful. We should really figure
+        // out how to playhead->getEditTime (or whatever it is) this value).
         for (auto& msg : *(fc.bufferForMidiMessages)) {
-            std::cout
-                << "Got midi message: "
-                << fc.streamTime.start
-                << " juce::Time seconds: " << Time::getMillisecondCounterHiRes() * 0.001
-                << msg.getTimeStamp() // This is not really meaningful. It's the time stamp within the block, which I believe is arbitrary. We should really figure out how to playhead->getEditTime (or whatever it is) this value
-                << " - "
-                << msg.getDescription()
-                << std::endl;
+            RealtimeLog::getInstance().logMidi("OpenFrameworksPlugin: Got midi message", msg,
+                                               { fc.streamTime.start, msg.getTimeStamp() });
         }
     }
 }
@@ -71,5 +92,17 @@ void OpenFrameworksPlugin::restorePluginStateFromValueTree(const juce::ValueTree
 {
     CachedValue<float>* cvsFloat[] = { &semitonesValue, nullptr };
     te::copyPropertiesToNullTerminatedCachedValues(v, cvsFloat);
+    CachedValue<String>* cvsString[] = { &oscHost, nullptr };
+    te::copyPropertiesToNullTerminatedCachedValues(v, cvsString);
+    CachedValue<int>* cvsInt[] = { &oscPort, nullptr };
+    te::copyPropertiesToNullTerminatedCachedValues(v, cvsInt);
+    oscSender.setTarget(oscHost, oscPort);
+}
+
+void OpenFrameworksPlugin::setOscTarget(const String& hostname, int port)
+{
+    oscHost = hostname;
+    oscPort = port;
+    oscSender.setTarget(hostname, port);
 }
 
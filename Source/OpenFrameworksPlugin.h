@@ -12,6 +12,7 @@
 
 #include <iostream>
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "MidiOscSender.h"
 
 namespace te = tracktion_engine;
 
@@ -26,6 +27,16 @@ public:
     juce::CachedValue<float> semitonesValue;
     te::AutomatableParameter::Ptr semitones;
 
+    /** MIDI that passes through the plugin is sent as OSC to this host and
+     port (see MidiOscSender). These are saved with the plugin's state. A port
+     of 0 (the default) disables sending. */
+    juce::CachedValue<String> oscHost;
+    juce::CachedValue<int> oscPort;
+
+    /** Set oscHost and oscPort, and start (or stop) sending. Call this on the
+     message thread. */
+    void setOscTarget(const String& hostname, int port);
+
     //==============================================================================
     static float getMaximumSemitones() { return 3.0f * 12.0f; }
 
@@ -59,5 +70,7 @@ public:
     void restorePluginStateFromValueTree(const juce::ValueTree&) override;
 
 private:
+    MidiOscSender oscSender;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OpenFrameworksPlugin)
 };
@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+    OscBenchmark.cpp
+    Created: 18 Oct 2026 5:03:22pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "OscBenchmark.h"
+
+/** Return p50, p99, p99.9 and max of values as a JSON object. Sorts values. */
+static var percentiles(std::vector<double>& values)
+{
+    auto* obj = new DynamicObject();
+    var result(obj);
+    if (values.empty()) return result;
+    std::sort(values.begin(), values.end());
+    auto at = [&values] (double p) {
+        size_t i = (size_t)jmax(0.0, std::ceil(p * values.size()) - 1.0);
+        return values[jmin(i, values.size() - 1)];
+    };
+    obj->setProperty("p50", at(0.5));
+    obj->setProperty("p99", at(0.99));
+    obj->setProperty("p999", at(0.999));
+    obj->setProperty("max", values.back());
+    return result;
+}
+
+OscBenchmark::OscBenchmark(int p, Array<int> periodsMs, double seconds) :
+    port(p),
+    periods(periodsMs),
+    runSeconds(seconds)
+{
+    receiver.addListener(this);
+}
+
+OscBenchmark::~OscBenchmark()
+{
+    stopTimer();
+    source = nullptr;
+    receiver.removeListener(this);
+    receiver.disconnect();
+}
+
+bool OscBenchmark::start()
+{
+    if (periods.isEmpty()) return false;
+    if (!receiver.connect(port)) {
+        std::cerr << "OscBenchmark: Failed to listen on port " << port << std::endl;
+        return false;
+    }
+    runIndex = 0;
+    startRun();
+    return true;
+}
+
+void OscBenchmark::startRun()
+{
+    int period = periods[runIndex];
+    size_t expected = (size_t)(runSeconds * 1000.0 / period * 1.2) + 1000;
+    arrivals.resize(expected);
+    numArrivals = 0;
+    numOverflowed = 0;
+
+    std::cout << "OscBenchmark: Measuring " << period << "ms period for " << runSeconds << " seconds" << std::endl;
+    source = std::make_unique<OscSource>("127.0.0.1", port, period, true);
+    startTimer((int)(runSeconds * 1000.0));
+}
+
+void OscBenchmark::oscMessageReceived(const OSCMessage& message)
+{
+    // This is called on the OSC receiver thread
+    if (message.size() < 2 || !message[0].isInt32() || !message[1].isBlob()) return;
+    double arrivedMs = Time::getMillisecondCounterHiRes();
+    const MemoryBlock& blob = message[1].getBlob();
+    if (blob.getSize() != sizeof(double)) return;
+
+    int index = numArrivals.load(std::memory_order_relaxed);
+    if (index >= (int)arrivals.size()) {
+        numOverflowed++;
+        return;
+    }
+    Arrival& a = arrivals[(size_t)index];
+    a.counter = message[0].getInt32();
+    std::memcpy(&a.sentMs, blob.getData(), sizeof(double));
+    a.arrivedMs = arrivedMs;
+    numArrivals.store(index + 1, std::memory_order_release);
+}
+
+void OscBenchmark::timerCallback()
+{
+    if (!waitingForTail) {
+        // Stop sending, and give the last messages time to arrive. Once
+        // stop returns, the number sent does not change.
+        if (source) source->stop();
+        waitingForTail = true;
+        startTimer(250);
+        return;
+    }
+    stopTimer();
+    waitingForTail = false;
+    finishRun();
+
+    if (++runIndex < periods.size()) {
+        startRun();
+    } else {
+        receiver.disconnect();
+        if (onFinished) onFinished();
+    }
+}
+
+void OscBenchmark::finishRun()
+{
+    int period = periods[runIndex];
+    int sent = source ? source->getNumSent() : 0;
+    source = nullptr;
+
+    int received = numArrivals.load(std::memory_order_acquire);
+    std::vector<double> latencies, jitters;
+    latencies.reserve((size_t)received);
+    jitters.reserve((size_t)received);
+    for (int i = 0; i < received; i++) {
+        const Arrival& a = arrivals[(size_t)i];
+        latencies.push_back(a.arrivedMs - a.sentMs);
+        if (i > 0) jitters.push_back(std::abs(a.arrivedMs - arrivals[(size_t)i - 1].arrivedMs - period));
+    }
+
+    auto* obj = new DynamicObject();
+    var result(obj);
+    obj->setProperty("bench", "osc");
+    obj->setProperty("periodMs", period);
+    obj->setProperty("rate", 1000.0 / period);
+    obj->setProperty("sent", sent);
+    obj->setProperty("received", received);
+    obj->setProperty("lost", jmax(0, sent - received));
+    obj->setProperty("overflowed", numOverflowed.load());
+    obj->setProperty("latencyMs", percentiles(latencies));
+    obj->setProperty("jitterMs", percentiles(jitters));
+    std::cout << JSON::toString(result, true) << std::endl;
+}
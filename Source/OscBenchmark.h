@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    OscBenchmark.h
+    Created: 18 Oct 2026 5:03:22pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <iostream>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "OscSource.h"
+
+/** OscBenchmark measures end-to-end OSC latency and jitter in one process. An
+ OscSource sends timestamped /test messages over UDP to a receiver on the
+ loopback interface. The receiver uses a realtime callback, so it records the
+ arrival time on the OSC thread, without waiting for the message thread.
+
+ Each period is measured for a fixed duration. After each run, one line of
+ JSON is printed to stdout, so results can be compared between builds:
+ {"bench": "osc", "periodMs": 1, "rate": 1000, "sent": 5000, "received": 5000,
+  "lost": 0, "latencyMs": {"p50": .., "p99": .., "p999": .., "max": ..},
+  "jitterMs": {"p50": .., "p99": .., "p999": .., "max": ..}}
+
+ Latency is arrival time minus send time. Jitter is how far each interval
+ between arrivals is from the period that OscSource was asked to send with.
+ */
+class OscBenchmark :
+    private Timer,
+    private OSCReceiver::Listener<OSCReceiver::RealtimeCallback>
+{
+public:
+    /** Measure each period (in milliseconds) for runSeconds. Messages are sent
+     to, and received on, the given UDP port. */
+    OscBenchmark(int port, Array<int> periodsMs, double runSeconds = 5.0);
+    ~OscBenchmark();
+
+    /** Start the first run. Returns false if the receiver could not connect */
+    bool start();
+
+    /** Called on the message thread after the last run */
+    std::function<void()> onFinished;
+
+private:
+    struct Arrival {
+        int counter;
+        double sentMs;
+        double arrivedMs;
+    };
+
+    void oscMessageReceived(const OSCMessage& message) override;
+    void timerCallback() override;
+    void startRun();
+    void finishRun();
+
+    int port;
+    Array<int> periods;
+    double runSeconds;
+    int runIndex = 0;
+    bool waitingForTail = false;
+
+    OSCReceiver receiver;
+    std::unique_ptr<OscSource> source;
+
+    /** Written by the OSC thread while a run is in progress, and only read by
+     the message thread after the run has finished. Preallocated, so the OSC
+     thread never allocates. */
+    std::vector<Arrival> arrivals;
+    std::atomic<int> numArrivals { 0 };
+    std::atomic<int> numOverflowed { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(OscBenchmark)
+};
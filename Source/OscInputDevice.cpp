@@ -9,6 +9,7 @@
 */
 
 #include "OscInputDevice.h"
+#include "RealtimeLog.h"
 
 
 
@@ -18,7 +19,7 @@ const String OscInputDevice::name{"OSC-Input-Device"};
  currently only allows one OSC device to exist at a time. If there is already
  an OSC Input Device in the device manager it will be removed before a new one
  is added. */
-Result createOscInputDevice(te::Engine& engine, const String& name, int listenPort)
+Result createOscInputDevice(te::Engine& engine, const String& name, int listenPort, const String& recordParam)
 {
     // CRASH_TRACER
     TRACKTION_ASSERT_MESSAGE_THREAD
@@ -43,10 +44,13 @@ Result createOscInputDevice(te::Engine& engine, const String& name, int listenPo
     {
         te::DeviceManager::ContextDeviceListRebuilder deviceRebuilder (engine.getDeviceManager());
         
-        OscInputDevice* oscDevice = new OscInputDevice(engine, name, listenPort);
+        OscInputDevice* oscDevice = new OscInputDevice(engine, name, listenPort, recordParam);
         engine.getDeviceManager().midiInputs.add (oscDevice);
         
         oscDevice->recordingEnabled = true; // from MidiInputDevice
+        // With end-to-end enabled, tracks that are targeted by the device will
+        // play the MIDI that we convert from OSC (see OscInputNode).
+        if (!oscDevice->isEndToEndEnabled()) oscDevice->flipEndToEnd();
         oscDevice->setEnabled (true); // from VirtualMidiInputDevice, which overrides others, but updates the protected InputDevice::enabled bool
         oscDevice->initialiseDefaultAlias();
         oscDevice->saveProps(); // Check: If this is commented out, is this still saved?
@@ -60,11 +64,12 @@ Result createOscInputDevice(te::Engine& engine, const String& name, int listenPo
 
 ////////////////////////////////////////////////////////////////////////
 
-OscInputDevice::OscInputDevice(te::Engine& e, const String& name, int listenPort) :
+OscInputDevice::OscInputDevice(te::Engine& e, const String& name, int listenPort, const String& recordParam) :
     // The VirtualMidiInputDevice constructor is specified with a type enum.
     // Below I am using the VirtualMidiInputDevice, which is technically
     // correct, but could also lead to some subtle bugs down the line.
-    VirtualMidiInputDevice(e, name, te::InputDevice::virtualMidiDevice)
+    VirtualMidiInputDevice(e, name, te::InputDevice::virtualMidiDevice),
+    recordParamName(recordParam)
 {
     std::cout << "Creating OscInputDevice" << std::endl;
     oscReceiver.addListener(this);
@@ -77,7 +82,11 @@ OscInputDevice::OscInputDevice(te::Engine& e, const String& name, int listenPort
 
 void OscInputDevice::masterTimeUpdate (double streamTime)
 {
-    adjustSecs = streamTime - Time::getMillisecondCounterHiRes() * 0.001;
+    // Scheduling hiccups in the audio callback would show up as jitter if we
+    // compared streamTime to the host clock directly. streamClock filters the
+    // host time of each block, so adjustSecs changes smoothly.
+    streamClock.update(streamTime, Time::getMillisecondCounterHiRes() * 0.001);
+    adjustSecs = streamClock.getAdjustSecs();
     atomicAdjustSecs = adjustSecs;
 
     auto received = incomingMessages.read();
@@ -85,10 +94,25 @@ void OscInputDevice::masterTimeUpdate (double streamTime)
         msg.streamTime = msg.arrivedAt + adjustSecs;
     }
 
+    // Everything in incomingMidi arrived during the previous block, so after
+    // converting to streamTime, it falls before the block that is about to be
+    // rendered. Delaying by exactly one block lets the live input node place
+    // each message at the same relative position in the next block, so the
+    // spacing between messages is preserved, and latency is constant.
+    const double blockLatency = engine.getDeviceManager().getBlockSizeMs() * 0.001;
+    auto receivedMidi = incomingMidi.read();
+    for (auto&& msg : receivedMidi) {
+        msg.streamTime = msg.arrivedAt + adjustSecs + blockLatency;
+    }
+
+    if (incomingMessages.checkAndClearLostMessages() || incomingMidi.checkAndClearLostMessages())
+        RealtimeLog::getInstance().log("OscInputDevice: incoming OSC queue was full. Dropped messages", { streamTime });
+
     const ScopedLock sl (instanceLock);
     for (auto instance : instances) {
         instance->masterTimeUpdate (streamTime);
         instance->handleOscMessages(received);
+        if (receivedMidi.size()) instance->handleMidiMessages(receivedMidi);
     }
 }
 
@@ -111,12 +135,96 @@ void OscInputDevice::removeInstance (OscInputDeviceInstance* i)
 
 void OscInputDevice::oscMessageReceived(const OSCMessage& message)
 {
-    double timeMs = Time::getMillisecondCounterHiRes();
-    incomingMessages.writeMessage(message, timeMs);
+    writeMessage(message, Time::getMillisecondCounterHiRes());
 }
 
 void OscInputDevice::oscBundleReceived(const OSCBundle& bundle)
 {
-    std::cout << "OSC bundle received" << std::endl;
+    writeBundle(bundle, Time::getMillisecondCounterHiRes());
+}
+
+void OscInputDevice::writeBundle(const OSCBundle& bundle, double receivedMs)
+{
+    double timeMs = receivedMs;
+    const OSCTimeTag timeTag = bundle.getTimeTag();
+    if (!timeTag.isImmediately()) {
+        // When the sender provides a timetag, that is a better indication of
+        // when the sender acted than our arrival time, which includes network
+        // and scheduling jitter. If the timetag is far from the arrival time,
+        // the clocks are probably not synchronized, so we ignore it.
+        double sentMs = timeTagToHiResMs(timeTag);
+        if (std::abs(sentMs - receivedMs) < 1000) timeMs = sentMs;
+    }
+
+    for (const auto& element : bundle) {
+        if (element.isMessage()) writeMessage(element.getMessage(), timeMs);
+        else if (element.isBundle()) writeBundle(element.getBundle(), timeMs);
+    }
+}
+
+double OscInputDevice::timeTagToHiResMs(const OSCTimeTag& timeTag)
+{
+    // Both clocks drift a little relative to each other, so re-sync the offset
+    // every few seconds. currentTimeMillis only has millisecond resolution,
+    // which is much better than the network jitter we are trying to remove.
+    double nowMs = Time::getMillisecondCounterHiRes();
+    if (lastWallClockSyncMs < 0 || nowMs - lastWallClockSyncMs > 10000) {
+        wallClockOffsetMs = (double)Time::currentTimeMillis() - nowMs;
+        lastWallClockSyncMs = nowMs;
+    }
+
+    // NTP timetags count seconds since 1900 in the upper 32 bits, and
+    // fractions of a second in the lower 32 bits.
+    const uint64 raw = timeTag.getRawTimeTag();
+    const double secondsFrom1900To1970 = 2208988800.0;
+    double ntpSecs = (double)(raw >> 32) + (double)(raw & 0xffffffff) / 4294967296.0;
+    double unixMs = (ntpSecs - secondsFrom1900To1970) * 1000.0;
+    return unixMs - wallClockOffsetMs;
+}
+
+void OscInputDevice::writeMessage(const OSCMessage& message, double timeMs)
+{
+    MidiMessage midiMessage;
+    if (convertToMidi(message, midiMessage)) {
+        incomingMidi.writeMessage({ timeMs * 0.001, 0.0, 0.0, midiMessage });
+        return;
+    }
+    incomingMessages.writeMessage(message, timeMs);
+}
+
+bool OscInputDevice::convertToMidi(const OSCMessage& message, MidiMessage& result)
+{
+    int args[3] = { 0, 0, 1 };
+    int numArgs = jmin(message.size(), 3);
+    for (int i = 0; i < numArgs; i++) {
+        if (message[i].isInt32()) args[i] = message[i].getInt32();
+        else if (message[i].isFloat32()) args[i] = (int)(message[i].getFloat32());
+        else return false;
+    }
+
+    const OSCAddressPattern pattern = message.getAddressPattern();
+    if (pattern.matches({"/note"})) {
+        if (numArgs < 2) return false;
+        int channel = jlimit(1, 16, numArgs >= 3 ? args[2] : 1);
+        int pitch = jlimit(0, 127, args[0]);
+        int velocity = jlimit(0, 127, args[1]);
+        result = velocity > 0
+            ? MidiMessage::noteOn(channel, pitch, (uint8)velocity)
+            : MidiMessage::noteOff(channel, pitch);
+        return true;
+    }
+    if (pattern.matches({"/noteoff"})) {
+        if (numArgs < 1) return false;
+        int channel = jlimit(1, 16, numArgs >= 2 ? args[1] : 1);
+        result = MidiMessage::noteOff(channel, jlimit(0, 127, args[0]));
+        return true;
+    }
+    if (pattern.matches({"/cc"})) {
+        if (numArgs < 2) return false;
+        int channel = jlimit(1, 16, numArgs >= 3 ? args[2] : 1);
+        result = MidiMessage::controllerEvent(channel, jlimit(0, 127, args[0]), jlimit(0, 127, args[1]));
+        return true;
+    }
+    return false;
 }
 
@@ -13,6 +13,7 @@
 #include <vector>
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "TimestampedTest.h"
+#include "StreamClock.h"
 #include "OscInputDeviceInstance.h"
 
 
@@ -28,7 +29,7 @@ class OscInputDevice :
     private OSCReceiver::Listener<OSCReceiver::RealtimeCallback>
 {
 public:
-    OscInputDevice(te::Engine& e, const String& name, int listenPort);
+    OscInputDevice(te::Engine& e, const String& name, int listenPort, const String& recordParam = {});
     
     void masterTimeUpdate (double streamTime) override;
     te::InputDeviceInstance* createInstance (te::EditPlaybackContext& c) override;
@@ -38,9 +39,25 @@ public:
     
     static const String name;
     std::atomic<double> atomicAdjustSecs { 0 };
+
+    /** When recording, OSC values are written to the automation curve of the
+     parameter with this name (or ID) on the target track. */
+    String recordParamName;
     
     void addInstance(OscInputDeviceInstance* i);
     void removeInstance(OscInputDeviceInstance* i);
+
+    /** This lock is held while instances are called from the audio thread */
+    const CriticalSection& getInstanceLock() const { return instanceLock; }
+
+    /** Convert a mapped OSC message to a MidiMessage. Returns false if the OSC
+     message is not mapped. Arguments may be int32 or float32. The channel is
+     optional, and defaults to 1.
+     - /note pitch velocity [channel] (a velocity of 0 is a note off)
+     - /noteoff pitch [channel]
+     - /cc controller value [channel]
+     */
+    static bool convertToMidi(const OSCMessage& message, MidiMessage& result);
     
 protected:
     juce::CriticalSection instanceLock;
@@ -49,15 +66,39 @@ protected:
 private:
     void oscMessageReceived(const OSCMessage& message) override;
     void oscBundleReceived(const OSCBundle& bundle) override;
-    
+
+    /** Queue a message that was sent (or received) at timeMs, which is in the
+     same units as Time::getMillisecondCounterHiRes. */
+    void writeMessage(const OSCMessage& message, double timeMs);
+
+    /** Queue all the messages in a bundle. If the bundle has a timetag, the
+     messages are stamped with the time it refers to. Otherwise, they are
+     stamped with receivedMs. */
+    void writeBundle(const OSCBundle& bundle, double receivedMs);
+
+    /** Convert an NTP timetag to Time::getMillisecondCounterHiRes units. This
+     assumes that the sender's clock is synchronized with ours. */
+    double timeTagToHiResMs(const OSCTimeTag& timeTag);
+
     OSCReceiver oscReceiver;
+
+    /** Smooths the mapping between host time and streamTime */
+    StreamClock streamClock;
+
+    /** The difference between wall clock time (which is what timetags refer
+     to) and the hi-res millisecond counter. Only used on the network thread. */
+    double wallClockOffsetMs = 0;
+    double lastWallClockSyncMs = -1;
     
     /** Get incoming messages from the network thread
      - write to this from the network thread in the OSCReceiver callback
      - read on the Built-in Output thread in the masterTimeUpdate callback
      */
     LockFreeOscMessageQueue incomingMessages;
+
+    /** Like incomingMessages, but for OSC messages that were mapped to MIDI */
+    LockFreeMidiMessageQueue incomingMidi;
 };
 
-Result createOscInputDevice(te::Engine& engine, const String& name, int listenPort);
+Result createOscInputDevice(te::Engine& engine, const String& name, int listenPort, const String& recordParam = {});
 
@@ -9,6 +9,24 @@
 */
 
 #include "OscInputDeviceInstance.h"
+#include "OscInputNode.h"
+#include "RealtimeLog.h"
+
+static ListenerList<OscInputDeviceInstance::Listener>& getInstanceListeners()
+{
+    static ListenerList<OscInputDeviceInstance::Listener> listeners;
+    return listeners;
+}
+
+void OscInputDeviceInstance::addInstanceListener(Listener* listener)
+{
+    getInstanceListeners().add(listener);
+}
+
+void OscInputDeviceInstance::removeInstanceListener(Listener* listener)
+{
+    getInstanceListeners().remove(listener);
+}
 
 OscInputDeviceInstance::OscInputDeviceInstance(OscInputDevice& d, te::EditPlaybackContext& c) :
     te::InputDeviceInstance(d, c),
@@ -16,11 +34,19 @@ OscInputDeviceInstance::OscInputDeviceInstance(OscInputDevice& d, te::EditPlayba
     recording(false)
 {
     getOscInput().addInstance(this);
+    getInstanceListeners().call([] (Listener& l) { l.oscInputInstancesChanged(); });
 }
 
 OscInputDeviceInstance::~OscInputDeviceInstance()
 {
     getOscInput().removeInstance(this);
+    getInstanceListeners().call([] (Listener& l) { l.oscInputInstancesChanged(); });
+}
+
+void OscInputDeviceInstance::setDataListener(Listener* listener)
+{
+    const ScopedLock sl (getOscInput().getInstanceLock());
+    dataListener = listener;
 }
 
 void OscInputDeviceInstance::masterTimeUpdate(double streamTime)
@@ -57,14 +83,34 @@ OscInputDevice& OscInputDeviceInstance::getOscInput()
     return static_cast<OscInputDevice&>(owner);
 }
 
-bool OscInputDeviceInstance::startRecording() { recording = true; return recording; }
+bool OscInputDeviceInstance::startRecording()
+{
+    if (auto* track = getTargetTrack())
+        recorder = std::make_unique<OscRecorder>(*track, recordingStartTime, getOscInput().recordParamName);
+    recording = true;
+    return recording;
+}
+
 bool OscInputDeviceInstance::isRecording() { return recording; }
 void OscInputDeviceInstance::stop() { recording = false; } // called on the message thread
 void OscInputDeviceInstance::recordWasCancelled() { recording = false; }
 double OscInputDeviceInstance::getPunchInTime() { return recordingStartTime; }
 te::Clip* OscInputDeviceInstance::applyRetrospectiveRecord (te::SelectionManager*) { return nullptr; }
-te::Clip::Array OscInputDeviceInstance::stopRecording() { recording = false; return {}; }
-te::AudioNode* OscInputDeviceInstance::createLiveInputNode() { return new te::MixerAudioNode(false, false); }
+
+te::Clip::Array OscInputDeviceInstance::stopRecording()
+{
+    recording = false;
+    if (!recorder) return {};
+    // The last few blocks of events may still be waiting for the message
+    // thread. The data listener also needs to see them, so let it do the
+    // reading if there is one.
+    if (dataListener) dataListener->oscInputFlushRequested();
+    else recordPending(toMessageThread.read());
+    recorder->finish(lastEditTime);
+    return recorder->getClips();
+}
+
+te::AudioNode* OscInputDeviceInstance::createLiveInputNode() { return new OscInputNode(*this); }
 
 te::Clip::Array OscInputDeviceInstance::applyLastRecordingToEdit (
     te::EditTimeRange recordedRange,
@@ -73,16 +119,58 @@ te::Clip::Array OscInputDeviceInstance::applyLastRecordingToEdit (
     bool discardRecordings,
     te::SelectionManager*)
 {
-    //std::cerr << "OscInputDeviceInstance::applyLastRecordingToEdit is currently a no-op!"<< std::endl;
-    return {};
+    if (!recorder) return {};
+    if (discardRecordings) {
+        recorder->discard();
+        return {};
+    }
+    return recorder->getClips();
+}
+
+void OscInputDeviceInstance::recordPending(const std::vector<TimestampedTest>& values)
+{
+    auto midiMsgs = toMessageThreadMidi.read();
+    if (!recorder) return;
+    for (auto& tt : values) recorder->addValue(tt.editTime, tt.value);
+    for (auto& tm : midiMsgs) recorder->addMidi(tm.editTime, tm.message);
 }
 
 // Should be called from the OscInputDevice
 void OscInputDeviceInstance::handleOscMessages(std::vector<TimestampedTest> ttMsgs)
 {
+    bool wrote = false;
     for (auto tt : ttMsgs)
     {
         tt.editTime = context.playhead.streamTimeToSourceTime(tt.streamTime);
-        if (recording && tt.editTime >= recordingStartTime) toMessageThread.writeMessage(tt);
+        if (recording && tt.editTime >= recordingStartTime) {
+            toMessageThread.writeMessage(tt);
+            wrote = true;
+        }
+    }
+    if (toMessageThread.checkAndClearLostMessages())
+        RealtimeLog::getInstance().log("OscInputDeviceInstance: message thread queue was full. Dropped values");
+    if (wrote && dataListener) dataListener->oscInputDataReady();
+}
+
+// Should be called from the OscInputDevice
+void OscInputDeviceInstance::handleMidiMessages(const std::vector<TimestampedMidi>& midiMsgs)
+{
+    // Recorded MIDI uses the time that the message was sent, which does not
+    // include the block of latency that was added for live playback.
+    const double adjustSecs = getOscInput().atomicAdjustSecs;
+    bool wrote = false;
+    for (auto tm : midiMsgs)
+    {
+        toLiveInputNode.writeMessage(tm);
+        tm.editTime = context.playhead.streamTimeToSourceTime(tm.arrivedAt + adjustSecs);
+        if (recording && tm.editTime >= recordingStartTime) {
+            toMessageThreadMidi.writeMessage(tm);
+            wrote = true;
+        }
     }
+    if (toLiveInputNode.checkAndClearLostMessages())
+        RealtimeLog::getInstance().log("OscInputDeviceInstance: live input queue was full. Dropped MIDI");
+    if (toMessageThreadMidi.checkAndClearLostMessages())
+        RealtimeLog::getInstance().log("OscInputDeviceInstance: message thread queue was full. Dropped MIDI");
+    if (wrote && dataListener) dataListener->oscInputDataReady();
 }
@@ -13,6 +13,7 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "TimestampedTest.h"
 #include "OscInputDevice.h"
+#include "OscRecorder.h"
 
 
 namespace te = tracktion_engine;
@@ -24,6 +25,32 @@ public:
     virtual ~OscInputDeviceInstance();
     OscInputDevice& getOscInput();
 
+    /** Implement this to find out when OSC input instances come and go, and
+     when an instance has data waiting for the message thread. */
+    struct Listener {
+        virtual ~Listener() = default;
+        /** Called on the message thread when any OscInputDeviceInstance is
+         created or deleted. Instances that are being created are not yet in
+         their EditPlaybackContext, so do not look for them until later. */
+        virtual void oscInputInstancesChanged() = 0;
+        /** Called on the audio thread after an instance wrote to one of its
+         message thread queues. This must not block. */
+        virtual void oscInputDataReady() = 0;
+        /** Called on the message thread when an instance needs everything
+         that is waiting in its queues applied right now, for example just
+         before recording stops. */
+        virtual void oscInputFlushRequested() = 0;
+    };
+    /** Add or remove a listener that is told about every instance. Only
+     call these on the message thread. */
+    static void addInstanceListener(Listener* listener);
+    static void removeInstanceListener(Listener* listener);
+
+    /** Set the listener that will be told when this instance has data for the
+     message thread. This locks the device, so once it returns, the previous
+     listener will not be called again. */
+    void setDataListener(Listener* listener);
+
     // Called by the OscInputDevice on the "Build-in Output" thread
     void masterTimeUpdate(double streamTime);
     
@@ -55,22 +82,35 @@ public:
     // getPunchInTime is identical to MidiInputDeviceInstance
     double getPunchInTime() override;
 
-    // see MidiInputDeviceInstance::stopRecording for what this is really supposed to do
+    /** Called on the message thread when the transport stops. Events that
+     are still queued are applied first, then notes that are still held are
+     ended. Otherwise the recording has already been applied to the edit (see
+     recordPending). */
     te::Clip::Array stopRecording() override;
 
     /** Process all the incoming OSC messages. Like `masterTimeUpdate` this is called by
      OscInputDevice on the "Built-in Output" thread. */
     void handleOscMessages(std::vector<TimestampedTest> ttMsgs);
+
+    /** Pass MIDI messages that were converted from OSC to the live input node.
+     Called by OscInputDevice on the "Built-in Output" thread. */
+    void handleMidiMessages(const std::vector<TimestampedMidi>& midiMsgs);
     
-    /** Called automatically, apparently on every block during recording */
+    /** Called on the message thread after the recording stops. Because
+     recordPending applies the recording as it happens, this only needs to
+     remove the recording if `discardRecordings` is true. */
     te::Clip::Array applyLastRecordingToEdit (te::EditTimeRange recordedRange,
                                               bool isLooping, te::EditTimeRange loopRange,
                                               bool discardRecordings,
                                               te::SelectionManager*) override;
 
     // see MidiInputDeviceInstance for what this is really supposed to do.
+    // We don't keep a retrospective buffer, so this is a no-op.
     te::Clip* applyRetrospectiveRecord (te::SelectionManager*) override;
     
+    /** Create an OscInputNode, which plays MIDI converted from OSC on the
+     target track. This is only called when end-to-end is enabled on the
+     OscInputDevice, and the instance has a target track. */
     te::AudioNode* createLiveInputNode() override;
     
     /** recordingStartTime refers to when the recording began. It does not get
@@ -84,10 +124,33 @@ public:
     /** Are we currently recording? */
     std::atomic<bool> recording;
     
+    /** Apply recorded values and MIDI to the edit. Call this regularly on the
+     message thread while recording, so that the work of converting the
+     recording is spread out over the length of the take. */
+    void recordPending(const std::vector<TimestampedTest>& values);
+
     /** Pass messages from edit to the message thread.
      It's a little bit risky to make this public, because we don't want anyone
      replacing it. It will be refactored when we template it, so for now just
      using a public member is a reasonable compromize. */
     LockFreeOscMessageQueue toMessageThread;
+
+    /** Pass MIDI messages from the OscInputDevice to the live input node. Both
+     ends of this queue run on the audio thread. */
+    LockFreeMidiMessageQueue toLiveInputNode;
+
+    /** Incremented by each new OscInputNode. Only the node with the latest
+     generation reads toLiveInputNode. */
+    std::atomic<int> liveInputGeneration { 0 };
+
+    /** Pass MIDI messages that should be recorded to the message thread */
+    LockFreeMidiMessageQueue toMessageThreadMidi;
+
+private:
+    /** Created when recording starts. Only used on the message thread. */
+    std::unique_ptr<OscRecorder> recorder;
+
+    /** Only read or written while holding the OscInputDevice's instanceLock */
+    Listener* dataListener = nullptr;
 };
 
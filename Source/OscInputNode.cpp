@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    OscInputNode.cpp
+    Created: 18 Oct 2026 10:12:31am
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "OscInputNode.h"
+#include "OscInputDeviceInstance.h"
+
+OscInputNode::OscInputNode(OscInputDeviceInstance& i) : instance(i)
+{
+}
+
+OscInputNode::~OscInputNode()
+{
+}
+
+void OscInputNode::getAudioNodeProperties (te::AudioNodeProperties& info)
+{
+    info.hasAudio = false;
+    info.hasMidi = true;
+    info.numberOfChannels = 0;
+}
+
+void OscInputNode::visitNodes (const VisitorFn& v)
+{
+    v (*this);
+}
+
+bool OscInputNode::purgeSubNodes (bool, bool keepMidi)
+{
+    return keepMidi;
+}
+
+void OscInputNode::releaseAudioNodeResources()
+{
+}
+
+void OscInputNode::prepareAudioNodeToPlay (const te::PlaybackInitialisationInfo&)
+{
+    // Anything that is still in the queue was intended for an old graph. The
+    // old graph's node may still be reading the queue on the audio thread, so
+    // we cannot empty it here. Instead, the old node stops reading when the
+    // generation changes, and we empty the queue on our first block.
+    generation = ++instance.liveInputGeneration;
+    needsDrain = true;
+    pending.clear();
+    pending.reserve(1024);
+}
+
+void OscInputNode::renderOver (const te::AudioRenderContext& rc)
+{
+    rc.clearAll();
+    renderAdding(rc);
+}
+
+void OscInputNode::renderAdding (const te::AudioRenderContext& rc)
+{
+    if (rc.bufferForMidiMessages == nullptr) return;
+    if (instance.liveInputGeneration.load(std::memory_order_acquire) != generation) return;
+
+    if (needsDrain) {
+        needsDrain = false;
+        instance.toLiveInputNode.readInto(pending);
+        pending.clear();
+    }
+
+    instance.toLiveInputNode.readInto(pending);
+    if (pending.empty()) return;
+
+    const double blockStart = rc.streamTime.start;
+    const double blockEnd = rc.streamTime.end;
+
+    // Messages that are due in this block are added at their offset within the
+    // block. Messages that were late (which can happen when the audio callback
+    // stalls) are added at the very start of the block. Everything else waits
+    // for a later block. Compacting in place keeps the order of the messages
+    // that are still pending, and does not allocate.
+    size_t numPending = 0;
+    for (auto& m : pending) {
+        if (m.streamTime < blockEnd) {
+            double offset = jmax(0.0, m.streamTime - blockStart);
+            rc.bufferForMidiMessages->addMidiMessage(m.message, rc.midiBufferOffset + offset, midiSourceID);
+        } else {
+            pending[numPending++] = m;
+        }
+    }
+    pending.resize(numPending);
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    OscInputNode.h
+    Created: 18 Oct 2026 10:12:31am
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <vector>
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "TimestampedTest.h"
+
+namespace te = tracktion_engine;
+
+class OscInputDeviceInstance;
+
+/** OscInputNode is the live input node for an OscInputDeviceInstance. It plays
+ MIDI messages that were converted from OSC by the OscInputDevice. Messages
+ arrive with a streamTime that already includes one block of latency, which
+ means that each message can be placed at a sample accurate offset within the
+ block that is being rendered. This is modeled after tracktion's
+ MidiInputDeviceNode, but much simpler, because we never loop or punch in.
+ */
+class OscInputNode : public te::AudioNode
+{
+public:
+    OscInputNode(OscInputDeviceInstance& instance);
+    virtual ~OscInputNode();
+
+    void getAudioNodeProperties (te::AudioNodeProperties&) override;
+    void visitNodes (const VisitorFn&) override;
+    bool purgeSubNodes (bool keepAudio, bool keepMidi) override;
+    void releaseAudioNodeResources() override;
+    void prepareAudioNodeToPlay (const te::PlaybackInitialisationInfo&) override;
+    bool isReadyToRender() override { return true; }
+
+    // Called on the audio thread
+    void renderOver (const te::AudioRenderContext&) override;
+    void renderAdding (const te::AudioRenderContext&) override;
+
+private:
+    OscInputDeviceInstance& instance;
+    te::MPESourceID midiSourceID = te::createUniqueMPESourceID();
+
+    /** Messages that were read from the instance, but are scheduled for a
+     later block. This is reserved in prepareAudioNodeToPlay so that the audio
+     thread never needs to allocate. */
+    std::vector<TimestampedMidi> pending;
+
+    /** Our value of the instance's liveInputGeneration. Only the newest node
+     reads the queue. It empties it on its first block, on the audio thread,
+     because the queue only allows one reader. */
+    int generation = 0;
+    bool needsDrain = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OscInputNode)
+};
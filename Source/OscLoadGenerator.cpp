@@ -0,0 +1,236 @@
+/*
+  ==============================================================================
+
+    OscLoadGenerator.cpp
+    Created: 18 Oct 2026 4:12:40pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "OscLoadGenerator.h"
+
+double OscLoadGenerator::Scenario::getRateAt(double seconds) const
+{
+    if (burstRate > 0 && burstEverySeconds > 0 && std::fmod(seconds, burstEverySeconds) < burstLengthSeconds)
+        return burstRate;
+    return rate;
+}
+
+Result OscLoadGenerator::Scenario::fromFile(const File& file, Scenario& scenario)
+{
+    if (!file.existsAsFile()) return Result::fail("Scenario file does not exist: " + file.getFullPathName());
+    var json;
+    auto result = JSON::parse(file.loadFileAsString(), json);
+    if (result.failed()) return result;
+    if (!json.isObject()) return Result::fail("Scenario must be a JSON object");
+    scenario = fromVar(json);
+    return Result::ok();
+}
+
+OscLoadGenerator::Scenario OscLoadGenerator::Scenario::fromVar(const var& json)
+{
+    Scenario s;
+    s.numThreads = jlimit(1, 64, (int)json.getProperty("threads", s.numThreads));
+    s.durationSeconds = jmax(0.1, (double)json.getProperty("duration", s.durationSeconds));
+    s.rate = jmax(1.0, (double)json.getProperty("rate", s.rate));
+    s.bundleSize = jlimit(1, 1024, (int)json.getProperty("bundleSize", s.bundleSize));
+
+    var burst = json.getProperty("burst", var());
+    if (burst.isObject()) {
+        s.burstRate = jmax(0.0, (double)burst.getProperty("rate", 0));
+        s.burstLengthSeconds = jmax(0.0, (double)burst.getProperty("length", 0));
+        s.burstEverySeconds = jmax(0.0, (double)burst.getProperty("every", 0));
+    }
+
+    if (auto* messages = json.getProperty("messages", var()).getArray()) {
+        for (auto& m : *messages) {
+            Message message;
+            message.address = m.getProperty("address", "/load/test").toString();
+            message.weight = jmax(0, (int)m.getProperty("weight", 1));
+            if (auto* args = m.getProperty("args", var()).getArray())
+                for (auto& arg : *args) message.args.add(arg.toString());
+            if (message.weight > 0 && message.address.startsWithChar('/')) s.messages.add(message);
+            else std::cerr << "OscLoad: skipping invalid message: " << message.address << std::endl;
+        }
+    }
+    if (s.messages.isEmpty()) s.messages.add({ "/load/test", { "i" }, 1 });
+    return s;
+}
+
+//==============================================================================
+class OscLoadGenerator::SenderThread : public Thread {
+public:
+    SenderThread(OscLoadGenerator& g, int index) :
+        Thread("OSC Load " + String(index)),
+        generator(g),
+        scenario(g.scenario),
+        random(index + 1)
+    {
+        for (auto& m : scenario.messages) {
+            totalWeight += m.weight;
+            cumulativeWeights.add(totalWeight);
+        }
+    }
+
+    bool connect() { return sender.connect(generator.hostname, generator.port); }
+
+    void run() override
+    {
+        const double threadShare = 1.0 / scenario.numThreads;
+        const double startMs = Time::getMillisecondCounterHiRes();
+        const double endMs = startMs + scenario.durationSeconds * 1000.0;
+        double dueMs = startMs;
+
+        while (!threadShouldExit()) {
+            double nowMs = Time::getMillisecondCounterHiRes();
+            if (nowMs >= endMs) break;
+
+            // Wait until the next packet is due. Sleep is coarse, so we yield
+            // for the last millisecond.
+            if (nowMs < dueMs) {
+                if (dueMs - nowMs > 1.5) Thread::sleep((int)(dueMs - nowMs - 1.0));
+                else Thread::yield();
+                continue;
+            }
+
+            bool ok;
+            if (scenario.bundleSize == 1) {
+                ok = sender.send(createMessage());
+            } else {
+                OSCBundle bundle;
+                for (int i = 0; i < scenario.bundleSize; i++) bundle.addElement(createMessage());
+                ok = sender.send(bundle);
+            }
+            if (ok) generator.numSent += scenario.bundleSize;
+            else generator.numFailed += scenario.bundleSize;
+
+            double rate = scenario.getRateAt((nowMs - startMs) / 1000.0) * threadShare;
+            dueMs += 1000.0 * scenario.bundleSize / rate;
+
+            // If we fall far behind, the rate is more than this thread can
+            // send. Don't try to catch up, because that would hide a slow
+            // sender in a burst that we never asked for.
+            if (nowMs - dueMs > 100.0) dueMs = nowMs;
+        }
+    }
+
+private:
+    OSCMessage createMessage()
+    {
+        int r = random.nextInt(totalWeight);
+        int i = 0;
+        while (cumulativeWeights[i] <= r) i++;
+        auto& spec = scenario.messages.getReference(i);
+
+        OSCMessage message{ OSCAddressPattern(spec.address) };
+        for (auto& arg : spec.args) {
+            if (arg == "i") message.addInt32(random.nextInt(128));
+            else if (arg == "f") message.addFloat32(random.nextFloat());
+            else if (arg.startsWith("s")) message.addString(arg.fromFirstOccurrenceOf(":", false, false));
+            else if (arg.startsWith("b:")) message.addBlob(getBlob(arg.fromFirstOccurrenceOf(":", false, false).getIntValue()));
+        }
+        return message;
+    }
+
+    const MemoryBlock& getBlob(int numBytes)
+    {
+        numBytes = jlimit(0, 60000, numBytes);
+        if ((int)blob.getSize() != numBytes) {
+            blob.setSize((size_t)numBytes);
+            for (int i = 0; i < numBytes; i++) blob[i] = (char)random.nextInt(256);
+        }
+        return blob;
+    }
+
+    OscLoadGenerator& generator;
+    const Scenario& scenario;
+    OSCSender sender;
+    Random random;
+    MemoryBlock blob;
+    Array<int> cumulativeWeights;
+    int totalWeight = 0;
+};
+
+//==============================================================================
+OscLoadGenerator::OscLoadGenerator(const String& h, int p, const Scenario& s) :
+    hostname(h),
+    port(p),
+    scenario(s)
+{
+}
+
+OscLoadGenerator::~OscLoadGenerator()
+{
+    stopTimer();
+    for (auto* t : threads) t->stopThread(1000);
+}
+
+bool OscLoadGenerator::start()
+{
+    if (!reportSender.connect(hostname, port)) {
+        std::cerr << "OscLoad: Failed to connect to " << hostname << ":" << port << std::endl;
+        return false;
+    }
+    for (int i = 0; i < scenario.numThreads; i++) {
+        auto* t = threads.add(new SenderThread(*this, i));
+        if (!t->connect()) {
+            std::cerr << "OscLoad: Failed to connect sender thread " << i << std::endl;
+            threads.clear();
+            return false;
+        }
+    }
+
+    std::cout
+        << "OscLoad: Sending to " << hostname << ":" << port
+        << " for " << scenario.durationSeconds << " seconds. "
+        << scenario.numThreads << " threads, " << scenario.rate << " msg/s";
+    if (scenario.burstRate > 0 && scenario.burstEverySeconds > 0)
+        std::cout
+            << ", bursts of " << scenario.burstRate << " msg/s for " << scenario.burstLengthSeconds
+            << "s every " << scenario.burstEverySeconds << "s";
+    if (scenario.bundleSize > 1) std::cout << ", " << scenario.bundleSize << " messages per bundle";
+    std::cout << std::endl;
+
+    reportSender.send(OSCMessage(OSCAddressPattern("/load/reset")));
+    startMs = lastReportMs = Time::getMillisecondCounterHiRes();
+    for (auto* t : threads) t->startThread(8);
+    startTimer(1000);
+    return true;
+}
+
+void OscLoadGenerator::timerCallback()
+{
+    double nowMs = Time::getMillisecondCounterHiRes();
+    int64 sent = numSent;
+    double seconds = (nowMs - lastReportMs) / 1000.0;
+    if (seconds > 0) {
+        double target = scenario.getRateAt((lastReportMs - startMs) / 1000.0);
+        std::cout
+            << "OscLoad: " << roundToInt((sent - numSentAtLastReport) / seconds) << " msg/s"
+            << " (target " << target << ")" << std::endl;
+    }
+    numSentAtLastReport = sent;
+    lastReportMs = nowMs;
+
+    for (auto* t : threads) if (t->isThreadRunning()) return;
+
+    stopTimer();
+    // Give the receiver a moment to process the tail of the test before it
+    // gets the report, without holding up the message thread.
+    WeakReference<OscLoadGenerator> weakThis(this);
+    Timer::callAfterDelay(100, [weakThis, sent, nowMs] {
+        if (auto* generator = weakThis.get()) generator->finish(sent, nowMs);
+    });
+}
+
+void OscLoadGenerator::finish(int64 sent, double endMs)
+{
+    reportSender.send({ "/load/report" }, OSCArgument((int32)jmin<int64>(sent, std::numeric_limits<int32>::max())));
+    std::cout
+        << "OscLoad: Finished. Sent " << sent << " messages in "
+        << (endMs - startMs) / 1000.0 << " seconds (" << roundToInt(sent / ((endMs - startMs) / 1000.0)) << " msg/s)";
+    if (numFailed > 0) std::cout << ". " << numFailed << " failed to send";
+    std::cout << std::endl;
+    if (onFinished) onFinished();
+}
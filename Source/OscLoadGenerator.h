@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    OscLoadGenerator.h
+    Created: 18 Oct 2026 4:12:40pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <iostream>
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** OscLoadGenerator sends realistic OSC traffic at a high rate, so that we
+ can find out where a receiver (like FluidOscServer) starts dropping messages.
+ Where OscSource sends a single /test message at a fixed period, this sends a
+ weighted mix of addresses and arguments from several threads, optionally in
+ bundles, with a steady rate and periodic bursts.
+
+ A scenario is a JSON object. Every field is optional:
+ {
+   "threads": 2,             // number of sender threads (each has a socket)
+   "duration": 10,           // seconds
+   "rate": 2000,             // steady messages per second (all threads)
+   "burst": { "rate": 20000, "length": 0.25, "every": 2 },
+   "bundleSize": 1,          // messages per packet. 1 sends plain messages
+   "messages": [
+     { "address": "/load/note", "args": ["i", "i"], "weight": 4 },
+     { "address": "/load/text", "args": ["s:hello", "f"], "weight": 1 },
+     { "address": "/load/blob", "args": ["b:256"], "weight": 1 }
+   ]
+ }
+ Argument types are "i" (random int 0-127), "f" (random float 0-1), "s" or
+ "s:text" (a string) and "b:N" (an N byte blob).
+
+ Before sending, the generator sends /load/reset. When it finishes, it sends
+ /load/report with the number of messages that it sent, so the receiver can
+ print how many it received and how many were dropped. The achieved send rate
+ is printed once per second.
+ */
+class OscLoadGenerator : private Timer {
+public:
+    struct Scenario {
+        struct Message {
+            String address;
+            StringArray args;
+            int weight = 1;
+        };
+
+        int numThreads = 1;
+        double durationSeconds = 10;
+        double rate = 1000;
+        double burstRate = 0;
+        double burstLengthSeconds = 0;
+        double burstEverySeconds = 0;
+        int bundleSize = 1;
+        Array<Message> messages;
+
+        /** Messages per second (for all threads) at a time since the start */
+        double getRateAt(double seconds) const;
+
+        /** Parse a scenario from a JSON file. If the file does not exist or
+         cannot be parsed, the Result explains why. */
+        static Result fromFile(const File& file, Scenario& scenario);
+        static Scenario fromVar(const var& json);
+    };
+
+    OscLoadGenerator(const String& hostname, int targetPort, const Scenario& scenario);
+    ~OscLoadGenerator();
+
+    /** Start all the sender threads. Returns false if we could not connect. */
+    bool start();
+
+    /** Called on the message thread after the generator has finished, and the
+     report has been sent */
+    std::function<void()> onFinished;
+
+    int64 getNumSent() const { return numSent; }
+
+private:
+    class SenderThread;
+
+    void timerCallback() override;
+    /** Send /load/report and print the summary */
+    void finish(int64 sent, double endMs);
+
+    String hostname;
+    int port;
+    Scenario scenario;
+    OwnedArray<SenderThread> threads;
+    OSCSender reportSender;
+
+    std::atomic<int64> numSent { 0 };
+    std::atomic<int64> numFailed { 0 };
+    int64 numSentAtLastReport = 0;
+    double startMs = 0;
+    double lastReportMs = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(OscLoadGenerator)
+    JUCE_DECLARE_WEAK_REFERENCEABLE(OscLoadGenerator)
+};
@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+    OscRecorder.cpp
+    Created: 18 Oct 2026 1:05:47pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "OscRecorder.h"
+
+OscRecorder::OscRecorder(te::AudioTrack& t, double punchInTime, const String& automationParamName) :
+    track(&t),
+    edit(t.edit),
+    punchIn(punchInTime)
+{
+    if (automationParamName.isEmpty()) return;
+    for (te::Plugin* plugin : t.pluginList) {
+        for (te::AutomatableParameter* p : plugin->getAutomatableParameters()) {
+            if (p->paramID.equalsIgnoreCase(automationParamName) || p->paramName.equalsIgnoreCase(automationParamName)) {
+                param = p;
+                std::cout << "Recording OSC values to automation: " << plugin->getName() << " - " << p->paramName << std::endl;
+                return;
+            }
+        }
+    }
+    std::cout << "Not recording OSC values to automation. Parameter not found: " << automationParamName << std::endl;
+}
+
+OscRecorder::~OscRecorder()
+{
+}
+
+void OscRecorder::addValue(double editTime, int value)
+{
+    if (!param) return;
+    if (numPointsAdded > 0 && editTime < lastPoint.time) return;
+
+    auto& curve = param->getCurve();
+    Point point{ editTime, jlimit(0.f, 1.f, value / 127.f), -1 };
+
+    // Thinning: if the most recent point lies on (or very near) the straight
+    // line between the point before it and this new point, it does not change
+    // the shape of the curve, so we replace it with the new point.
+    if (numPointsAdded >= 2 && lastPoint.index >= 0) {
+        double span = point.time - secondToLastPoint.time;
+        double proportion = span > 0 ? (lastPoint.time - secondToLastPoint.time) / span : 1.0;
+        float interpolated = secondToLastPoint.value + (float)proportion * (point.value - secondToLastPoint.value);
+        // Other writers (like /plugin/param/automation) may have added or
+        // removed points since, so the stored index is only a hint. If the
+        // point is gone, there is nothing to thin.
+        const int index = findAddedPoint(lastPoint.index, addedPoints.getLast());
+        if (index >= 0 && std::abs(interpolated - lastPoint.value) <= thinningTolerance) {
+            curve.removePoint(index, nullptr);
+            addedPoints.removeLast();
+            float value = param->valueRange.convertFrom0to1(point.value);
+            point.index = curve.addPoint(point.time, value, 0.0f, nullptr);
+            addedPoints.add({ point.time, value });
+            lastPoint = point;
+            return;
+        }
+    }
+
+    float value = param->valueRange.convertFrom0to1(point.value);
+    point.index = curve.addPoint(point.time, value, 0.0f, nullptr);
+    addedPoints.add({ point.time, value });
+    secondToLastPoint = lastPoint;
+    lastPoint = point;
+    numPointsAdded++;
+}
+
+int OscRecorder::findAddedPoint(int hint, const AddedPoint& added) const
+{
+    auto& curve = param->getCurve();
+    auto isAdded = [&curve, &added](int i) {
+        return i >= 0 && i < curve.getNumPoints()
+            && curve.getPointTime(i) == added.time && curve.getPointValue(i) == added.value;
+    };
+    if (isAdded(hint)) return hint;
+    for (int i = curve.getNumPoints(); --i >= 0;)
+        if (isAdded(i)) return i;
+    return -1;
+}
+
+void OscRecorder::addMidi(double editTime, const MidiMessage& message)
+{
+    // The target track was deleted while we were recording
+    if (!getTrack()) return;
+    int channel = jlimit(1, 16, message.getChannel()) - 1;
+
+    if (message.isNoteOn()) {
+        // A second note on for a held note ends the first one
+        HeldNote& held = heldNotes[channel][message.getNoteNumber()];
+        if (held.start >= 0) addMidi(editTime, MidiMessage::noteOff(channel + 1, message.getNoteNumber()));
+        held.start = editTime;
+        held.velocity = message.getVelocity();
+        getOrCreateClip(editTime);
+    }
+    else if (message.isNoteOff()) {
+        HeldNote& held = heldNotes[channel][message.getNoteNumber()];
+        if (held.start < 0) return;
+        auto* c = getOrCreateClip(held.start);
+        ensureClipContains(editTime);
+        double startBeat = toClipBeats(held.start);
+        double lengthInBeats = jmax(1.0 / 960.0, toClipBeats(editTime) - startBeat);
+        c->getSequence().addNote(message.getNoteNumber(), startBeat, lengthInBeats, held.velocity, 0, nullptr);
+        held.start = -1;
+    }
+    else if (message.isController()) {
+        auto* c = getOrCreateClip(editTime);
+        ensureClipContains(editTime);
+        // tracktion stores controller values with 14 bit resolution
+        c->getSequence().addControllerEvent(toClipBeats(editTime),
+                                            message.getControllerNumber(),
+                                            message.getControllerValue() << 7,
+                                            nullptr);
+    }
+}
+
+void OscRecorder::finish(double editTime)
+{
+    for (int channel = 0; channel < 16; channel++)
+        for (int pitch = 0; pitch < 128; pitch++)
+            if (heldNotes[channel][pitch].start >= 0)
+                addMidi(editTime, MidiMessage::noteOff(channel + 1, pitch));
+
+    if (clip && editTime > clip->getPosition().getStart())
+        clip->setEnd(editTime, true);
+}
+
+void OscRecorder::discard()
+{
+    if (clip) {
+        clip->removeFromParentTrack();
+        clip = nullptr;
+    }
+    if (param && addedPoints.size() > 0) {
+        // Only remove the points that we added. Walk backwards, because the
+        // curve is sorted by time, and so are the points we added.
+        auto& curve = param->getCurve();
+        int next = addedPoints.size() - 1;
+        for (int i = curve.getNumPoints(); --i >= 0 && next >= 0;) {
+            double time = curve.getPointTime(i);
+            while (next >= 0 && addedPoints.getReference(next).time > time) next--;
+            if (next < 0) break;
+            auto& added = addedPoints.getReference(next);
+            if (added.time == time && added.value == curve.getPointValue(i)) {
+                curve.removePoint(i, nullptr);
+                next--;
+            }
+        }
+        addedPoints.clear();
+        numPointsAdded = 0;
+    }
+}
+
+te::Clip::Array OscRecorder::getClips() const
+{
+    te::Clip::Array clips;
+    if (clip) clips.add(clip.get());
+    return clips;
+}
+
+te::AudioTrack* OscRecorder::getTrack() const
+{
+    return dynamic_cast<te::AudioTrack*>(track.get());
+}
+
+te::MidiClip* OscRecorder::getOrCreateClip(double editTime)
+{
+    if (!clip) {
+        auto* t = getTrack();
+        if (!t) return nullptr;
+        double start = jmax(0.0, jmin(punchIn, editTime));
+        clip = t->insertMIDIClip("OSC Recording", { start, editTime + 4.0 }, nullptr);
+    }
+    return clip.get();
+}
+
+void OscRecorder::ensureClipContains(double editTime)
+{
+    // Growing the clip in big steps means that we are not resizing it on
+    // every single event.
+    if (clip && editTime >= clip->getPosition().getEnd())
+        clip->setEnd(editTime + 4.0, true);
+}
+
+double OscRecorder::toClipBeats(double editTime)
+{
+    return edit.tempoSequence.timeToBeats(editTime) - clip->getStartBeat();
+}
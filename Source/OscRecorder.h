@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    OscRecorder.h
+    Created: 18 Oct 2026 1:05:47pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+
+namespace te = tracktion_engine;
+
+/** OscRecorder turns a recorded OSC stream into tracktion objects as it
+ arrives, so there is very little work left to do when recording stops.
+ - MIDI that was converted from OSC is written to a MIDI clip on the target
+   track. The clip is created when the first event arrives, and grows as the
+   recording gets longer.
+ - Integer values (like /test 42) are written as points on the automation
+   curve of a named parameter on the target track. Points that fall on a
+   straight line between their neighbors are thinned as we go.
+
+ All methods must be called on the message thread.
+ */
+class OscRecorder {
+public:
+    OscRecorder(te::AudioTrack& targetTrack, double punchInTime, const String& automationParamName);
+    ~OscRecorder();
+
+    /** Add a value at an edit time. Values are mapped from 0-127 to the
+     normalized range of the automation parameter. */
+    void addValue(double editTime, int value);
+
+    /** Add a MIDI event at an edit time. Notes are written to the clip when
+     the matching note off arrives. */
+    void addMidi(double editTime, const MidiMessage& message);
+
+    /** End any notes that are still held, and trim the clip. Events that
+     arrive after this are still applied. */
+    void finish(double editTime);
+
+    /** Remove everything that this recorder added to the edit. Automation
+     points that were on the curve before recording started are kept. */
+    void discard();
+
+    /** Returns the clip that we recorded into, if any */
+    te::Clip::Array getClips() const;
+
+    /** Points that deviate from a straight line by less than this (in the
+     normalized 0-1 range) are thinned */
+    float thinningTolerance = 0.002f;
+
+private:
+    te::MidiClip* getOrCreateClip(double editTime);
+    void ensureClipContains(double editTime);
+    double toClipBeats(double editTime);
+
+    /** Returns the target track, or nullptr if it was deleted while we were
+     recording */
+    te::AudioTrack* getTrack() const;
+
+    te::Selectable::WeakRef track;
+    te::Edit& edit;
+    double punchIn;
+
+    te::MidiClip::Ptr clip;
+    te::AutomatableParameter::Ptr param;
+
+    /** Start time and velocity of held notes, indexed by channel and pitch */
+    struct HeldNote { double start = -1; int velocity = 0; };
+    HeldNote heldNotes[16][128];
+
+    /** The last two automation points we added. We can only remove the most
+     recent point (when it turns out to be redundant), so these are always at
+     the end of the range we are recording. Indexes are where the points were
+     added, and may have moved since. */
+    struct Point { double time = 0; float value = 0; int index = -1; };
+    Point lastPoint, secondToLastPoint;
+    int numPointsAdded = 0;
+
+    /** Every point that is still on the curve because of us, so that discard
+     can leave the points that were there before alone */
+    struct AddedPoint { double time; float value; };
+    Array<AddedPoint> addedPoints;
+    /** Returns the index of a point we added, or -1 if it is no longer on the
+     curve. Checks the hint first, then searches by time and value. */
+    int findAddedPoint(int hint, const AddedPoint& added) const;
+
+    JUCE_DECLARE_NON_COPYABLE(OscRecorder)
+};
@@ -14,7 +14,13 @@
 
 class OscSource : private HighResolutionTimer {
 public:
-    OscSource(String hostname, int targetPort, int periodInMilliseconds) : periodMs(periodInMilliseconds) {
+    /** When timestamped is true, each /test message also includes an 8 byte
+     blob with the send time from Time::getMillisecondCounterHiRes (a double).
+     A receiver in the same process can use it to measure latency. */
+    OscSource(String hostname, int targetPort, int periodInMilliseconds, bool timestamped = false) :
+        periodMs(periodInMilliseconds),
+        sendTimestamps(timestamped)
+    {
         if (sender.connect(hostname, targetPort)) {
             std::cout << "Sending '/test' every " << periodMs << " milliseconds" << std::endl;
             start();
@@ -28,10 +34,18 @@ public:
     void stop() { stopTimer(); }
     
     void hiResTimerCallback() {
-        sender.send({"/test"}, OSCArgument(counter++));
+        if (sendTimestamps) {
+            double now = Time::getMillisecondCounterHiRes();
+            sender.send({"/test"}, OSCArgument(counter++), OSCArgument(MemoryBlock(&now, sizeof(now))));
+        } else {
+            sender.send({"/test"}, OSCArgument(counter++));
+        }
     }
+
+    int getNumSent() const { return counter; }
 private:
     juce::OSCSender sender;
-    int counter = 0;
+    std::atomic<int> counter { 0 };
     int periodMs;
+    bool sendTimestamps;
 };
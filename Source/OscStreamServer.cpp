@@ -0,0 +1,332 @@
+/*
+  ==============================================================================
+
+    OscStreamServer.cpp
+    Created: 18 Oct 2026 10:32:08pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "OscStreamServer.h"
+
+namespace {
+/** Reads OSC 1.0 types from a packet. JUCE has an equivalent, but it is
+ private to juce::OSCReceiver. */
+class OscPacketReader {
+public:
+    OscPacketReader(const void* d, size_t s) : data(static_cast<const char*>(d)), size(s) {}
+
+    OSCBundle::Element readElement(size_t elementSize) {
+        if (elementSize < 4 || elementSize > remaining()) throw OSCFormatError("OSC element has an invalid size");
+        if (data[pos] == '#') return readBundle(elementSize);
+        if (data[pos] == '/') return readMessage(elementSize);
+        throw OSCFormatError("OSC packet is not a message or a bundle");
+    }
+
+private:
+    size_t remaining() const { return size - pos; }
+
+    void require(size_t bytes) {
+        if (bytes > remaining()) throw OSCFormatError("OSC packet ended unexpectedly");
+    }
+
+    uint64 readUint64() {
+        uint64 high = readUint32();
+        return (high << 32) | readUint32();
+    }
+
+    uint32 readUint32() {
+        require(4);
+        uint32 value = ByteOrder::bigEndianInt(data + pos);
+        pos += 4;
+        return value;
+    }
+
+    String readString() {
+        const size_t start = pos;
+        while (pos < size && data[pos] != 0) pos++;
+        if (pos >= size) throw OSCFormatError("OSC string is not terminated");
+        String s = String::fromUTF8(data + start, (int)(pos - start));
+        pos = start + ((pos - start) / 4 + 1) * 4; // skip the padding
+        if (pos > size) throw OSCFormatError("OSC string is not padded");
+        return s;
+    }
+
+    MemoryBlock readBlob() {
+        const size_t blobSize = readUint32();
+        require(blobSize);
+        MemoryBlock blob(data + pos, blobSize);
+        pos += (blobSize + 3) & ~(size_t)3;
+        if (pos > size) throw OSCFormatError("OSC blob is not padded");
+        return blob;
+    }
+
+    OSCBundle::Element readMessage(size_t messageSize) {
+        const size_t end = pos + messageSize;
+        OSCMessage message{ OSCAddressPattern(readString()) };
+        if (pos >= end) return OSCBundle::Element(message); // some senders omit an empty type tag
+
+        String types = readString();
+        if (!types.startsWithChar(',')) throw OSCFormatError("OSC type tag string must begin with ','");
+
+        for (auto t = types.getCharPointer() + 1; !t.isEmpty(); ++t) {
+            switch (*t) {
+                case 'i': message.addInt32((int32)readUint32()); break;
+                case 'f': {
+                    uint32 bits = readUint32();
+                    float f;
+                    std::memcpy(&f, &bits, 4);
+                    message.addFloat32(f);
+                    break;
+                }
+                case 's': message.addString(readString()); break;
+                case 'b': message.addBlob(readBlob()); break;
+                // Types that JUCE cannot represent are converted to the
+                // nearest type our handlers understand.
+                case 'T': message.addInt32(1); break;
+                case 'F': message.addInt32(0); break;
+                case 'N': case 'I': break;
+                case 'd': {
+                    uint64 bits = readUint64();
+                    double d;
+                    std::memcpy(&d, &bits, 8);
+                    message.addFloat32((float)d);
+                    break;
+                }
+                case 'h': {
+                    message.addInt32((int32)(int64)readUint64());
+                    break;
+                }
+                default: throw OSCFormatError("Unsupported OSC type: " + String::charToString(*t));
+            }
+        }
+        if (pos > end) throw OSCFormatError("OSC message is longer than its size");
+        pos = end;
+        return OSCBundle::Element(message);
+    }
+
+    OSCBundle::Element readBundle(size_t bundleSize) {
+        const size_t end = pos + bundleSize;
+        if (readString() != "#bundle") throw OSCFormatError("OSC bundle must begin with #bundle");
+        OSCBundle bundle{ OSCTimeTag(readUint64()) };
+
+        while (pos < end) {
+            const size_t elementSize = readUint32();
+            if (elementSize > end - pos) throw OSCFormatError("OSC bundle element is larger than the bundle");
+            bundle.addElement(readElement(elementSize));
+        }
+        return OSCBundle::Element(bundle);
+    }
+
+    const char* data;
+    size_t size;
+    size_t pos = 0;
+};
+} // namespace
+
+OSCBundle::Element OscStreamServer::parsePacket(const void* data, size_t size)
+{
+    return OscPacketReader(data, size).readElement(size);
+}
+
+//==============================================================================
+class OscStreamServer::Connection : public Thread {
+public:
+    Connection(OscStreamServer& o, StreamingSocket* s) :
+        Thread("OSC Stream " + s->getHostName()),
+        owner(o),
+        socket(s),
+        pending(std::make_shared<std::atomic<int>>(0))
+    {
+    }
+
+    ~Connection()
+    {
+        socket->close();
+        stopThread(2000);
+    }
+
+    int getNumPending() const { return pending->load(); }
+
+    void run() override
+    {
+        CYBR_LOG(server, info, "OscStreamServer: Connected to " << socket->getHostName());
+        HeapBlock<uint8> buffer(readSize);
+
+        while (!threadShouldExit()) {
+            // Backpressure: stop reading while the message thread is behind.
+            // TCP's receive window fills, and the sender has to wait.
+            if (pending->load() >= owner.maxPendingPackets) {
+                wait(2);
+                continue;
+            }
+
+            const int ready = socket->waitUntilReady(true, 100);
+            if (ready < 0) break;
+            if (ready == 0) continue;
+            const int numRead = socket->read(buffer, readSize, false);
+            if (numRead <= 0) break; // closed, or an error
+
+            for (int i = 0; i < numRead; i++)
+                if (!addByte(buffer[i])) break;
+            if (failed) break;
+        }
+
+        if (failed) CYBR_LOG(server, warn, "OscStreamServer: Closing connection to " << socket->getHostName());
+        else CYBR_LOG(server, info, "OscStreamServer: Disconnected from " << socket->getHostName());
+        socket->close();
+    }
+
+private:
+    enum class Framing { unknown, slip, sizePrefix };
+    static constexpr int readSize = 65536;
+    static constexpr uint8 slipEnd = 0xc0, slipEsc = 0xdb, slipEscEnd = 0xdc, slipEscEsc = 0xdd;
+
+    /** Returns false if the connection should be closed */
+    bool addByte(uint8 b)
+    {
+        if (framing == Framing::unknown) {
+            // A size prefix starts with a zero byte, unless a packet is
+            // larger than 16 MB. A SLIP stream starts with END or '/' or '#'.
+            framing = (b == 0) ? Framing::sizePrefix : Framing::slip;
+        }
+
+        if (framing == Framing::slip) {
+            if (b == slipEnd) {
+                // Senders may begin packets with END too. Ignore empty packets.
+                if (packet.getSize() > 0) return emitPacket();
+                return true;
+            }
+            if (escaped) {
+                escaped = false;
+                if (b == slipEscEnd) b = slipEnd;
+                else if (b == slipEscEsc) b = slipEsc;
+            } else if (b == slipEsc) {
+                escaped = true;
+                return true;
+            }
+            return appendToPacket(b);
+        }
+
+        // Size prefix
+        if (headerBytes < 4) {
+            expectedSize = (expectedSize << 8) | b;
+            if (++headerBytes < 4) return true;
+            if (expectedSize == 0) return fail("Empty packet");
+            if (expectedSize > (uint32)owner.maxPacketSize) return fail("Packet is larger than maxPacketSize");
+            packet.preallocate(expectedSize);
+            return true;
+        }
+        if (!appendToPacket(b)) return false;
+        return (packet.getSize() == expectedSize) ? emitPacket() : true;
+    }
+
+    bool appendToPacket(uint8 b)
+    {
+        if ((int)packet.getSize() >= owner.maxPacketSize) return fail("Packet is larger than maxPacketSize");
+        packet.writeByte((char)b);
+        return true;
+    }
+
+    bool emitPacket()
+    {
+        try {
+            auto element = std::make_shared<OSCBundle::Element>(parsePacket(packet.getData(), packet.getSize()));
+            auto counter = pending;
+            counter->fetch_add(1);
+            auto weakOwner = owner.weakThis;
+            MessageManager::callAsync([weakOwner, element, counter] {
+                counter->fetch_sub(1);
+                if (auto* server = weakOwner.get()) server->dispatch(*element);
+            });
+        } catch (const OSCFormatError& e) {
+            // Skip the packet. The framing tells us where the next one starts.
+            CYBR_LOG(server, warn, "OscStreamServer: Invalid OSC packet: " << e.description);
+        }
+        packet.reset();
+        headerBytes = 0;
+        expectedSize = 0;
+        return true;
+    }
+
+    bool fail(const String& reason)
+    {
+        // If a packet is too large, we cannot find the start of the next one
+        CYBR_LOG(server, warn, "OscStreamServer: " << reason);
+        failed = true;
+        return false;
+    }
+
+    OscStreamServer& owner;
+    std::unique_ptr<StreamingSocket> socket;
+    std::shared_ptr<std::atomic<int>> pending;
+
+    Framing framing = Framing::unknown;
+    MemoryOutputStream packet;
+    bool escaped = false;
+    bool failed = false;
+    int headerBytes = 0;
+    uint32 expectedSize = 0;
+};
+
+//==============================================================================
+OscStreamServer::OscStreamServer() : Thread("OSC Stream Server")
+{
+    weakThis = this;
+}
+
+OscStreamServer::~OscStreamServer()
+{
+    stop();
+}
+
+bool OscStreamServer::start(int port)
+{
+    stop();
+    if (!listener.createListener(port)) return false;
+    startThread();
+    return true;
+}
+
+void OscStreamServer::stop()
+{
+    // Closing the listener wakes the thread from waitForNextConnection
+    signalThreadShouldExit();
+    listener.close();
+    stopThread(2000);
+    const ScopedLock sl (connectionsLock);
+    connections.clear();
+}
+
+void OscStreamServer::run()
+{
+    while (!threadShouldExit()) {
+        StreamingSocket* socket = listener.waitForNextConnection();
+        if (!socket) continue;
+
+        const ScopedLock sl (connectionsLock);
+        // Forget connections that have closed
+        for (int i = connections.size(); --i >= 0;)
+            if (!connections[i]->isThreadRunning()) connections.remove(i);
+
+        connections.add(new Connection(*this, socket))->startThread();
+    }
+}
+
+int OscStreamServer::getNumPending()
+{
+    const ScopedLock sl (connectionsLock);
+    int total = 0;
+    for (auto* connection : connections) total += connection->getNumPending();
+    return total;
+}
+
+void OscStreamServer::dispatch(const OSCBundle::Element& element)
+{
+    if (element.isMessage()) {
+        if (onMessage) onMessage(element.getMessage());
+    } else if (element.isBundle()) {
+        if (onBundle) onBundle(element.getBundle());
+    }
+}
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    OscStreamServer.h
+    Created: 18 Oct 2026 10:32:08pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "CybrLog.h"
+
+/** OscStreamServer receives OSC over TCP. UDP packets are limited to 64 KB,
+ so a large bundle (like a MIDI clip with thousands of notes) is truncated or
+ dropped by an OSCReceiver. A stream has no size limit, arrives in order, and
+ if the server falls behind, TCP slows the sender down instead of dropping.
+
+ Each connection may use either of the two OSC stream framings. The framing
+ is detected from the first byte:
+ - OSC 1.1: packets are SLIP encoded (RFC 1055), and end with 0xC0
+ - OSC 1.0: each packet is preceded by its size, as a big endian int32
+
+ Every connection has its own thread that reads and parses packets. Packets
+ are passed to onMessage or onBundle on the message thread, in the order they
+ were received. When a connection has more than maxPendingPackets waiting for
+ the message thread, it stops reading until the message thread catches up.
+ */
+class OscStreamServer : private Thread {
+public:
+    OscStreamServer();
+    ~OscStreamServer();
+
+    /** Listen for TCP connections. Returns false if we could not bind the port. */
+    bool start(int port);
+    void stop();
+
+    std::function<void(const OSCMessage&)> onMessage;
+    std::function<void(const OSCBundle&)> onBundle;
+
+    /** Packets from every connection that are waiting for the message thread */
+    int getNumPending();
+
+    int maxPacketSize = 64 * 1024 * 1024;
+    int maxPendingPackets = 64;
+
+    /** Parse an OSC message or bundle. Throws OSCFormatError if the data is
+     not valid OSC. */
+    static OSCBundle::Element parsePacket(const void* data, size_t size);
+
+private:
+    class Connection;
+    void run() override;
+    /** Called on the message thread */
+    void dispatch(const OSCBundle::Element& element);
+
+    StreamingSocket listener;
+    CriticalSection connectionsLock;
+    OwnedArray<Connection> connections;
+    /** Created on the message thread, and copied by the connection threads.
+     Creating a WeakReference to us is not thread safe. */
+    WeakReference<OscStreamServer> weakThis;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(OscStreamServer)
+    JUCE_DECLARE_NON_COPYABLE(OscStreamServer)
+};
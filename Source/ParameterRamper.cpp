@@ -0,0 +1,301 @@
+/*
+  ==============================================================================
+
+    ParameterRamper.cpp
+    Created: 19 Oct 2026 1:07:42am
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "ParameterRamper.h"
+#include "cybr_helpers.h"
+
+ParameterRamper::ParameterRamper(AudioDeviceManager& dm) :
+    deviceManager(dm),
+    slots(new Slot[maxSlots])
+{
+    ramps.ensureStorageAllocated(maxRamps);
+    deviceManager.addAudioCallback(this);
+}
+
+ParameterRamper::~ParameterRamper()
+{
+    // After this returns, the audio thread cannot be in our callback
+    deviceManager.removeAudioCallback(this);
+    stopTimer();
+}
+
+float ParameterRamper::shape(float progress, float curve)
+{
+    progress = jlimit(0.0f, 1.0f, progress);
+    if (curve == 0) return progress;
+    return std::pow(progress, std::pow(4.0f, jlimit(-1.0f, 1.0f, curve)));
+}
+
+float ParameterRamper::advance(Ramp& r, double seconds)
+{
+    r.elapsedSeconds += seconds;
+    const float progress = r.durationSeconds > 0 ? (float)(r.elapsedSeconds / r.durationSeconds) : 1.0f;
+    if (progress >= 1.0f) r.done = true;
+    return r.start + (r.target - r.start) * shape(progress, r.curve);
+}
+
+bool ParameterRamper::startRamp(te::Plugin& plugin, te::AutomatableParameter& param,
+                                float target, double durationSeconds, float curve)
+{
+    cancel(param);
+    // A value that is waiting must not jump the parameter back mid-ramp
+    for (int i = 0; i < numSlots; i++) {
+        if (slots[i].param.get() != &param) continue;
+        slots[i].dirty.store(false);
+        slots[i].needsNotify = false;
+    }
+
+    Ramp ramp;
+    ramp.plugin = &plugin;
+    ramp.param = &param;
+    ramp.processorParam = getProcessorParameter(plugin, param);
+    ramp.target = jlimit(0.0f, 1.0f, target);
+    ramp.durationSeconds = jmax(0.0, durationSeconds);
+    ramp.curve = curve;
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+        if (ramps.size() >= maxRamps) return false;
+        ramps.add(ramp); // never allocates, because of ensureStorageAllocated
+    }
+    startTicking();
+    return true;
+}
+
+bool ParameterRamper::setValue(te::Plugin& plugin, te::AutomatableParameter& param, float value)
+{
+    cancel(param);
+
+    Slot* slot = nullptr;
+    for (int i = 0; i < numSlots; i++) {
+        if (slots[i].param.get() == &param) {
+            slot = &slots[i];
+            break;
+        }
+    }
+    if (!slot) {
+        if (numSlots >= maxSlots) return false;
+        AudioProcessorParameter* processorParam = getProcessorParameter(plugin, param);
+        const SpinLock::ScopedLockType sl(lock);
+        slot = &slots[numSlots++];
+        slot->plugin = &plugin;
+        slot->param = &param;
+        slot->processorParam = processorParam;
+    }
+
+    slot->value.store(jlimit(0.0f, 1.0f, value), std::memory_order_relaxed);
+    slot->dirty.store(true, std::memory_order_release);
+    slot->needsNotify = true;
+    startTicking();
+    return true;
+}
+
+void ParameterRamper::flush(te::Edit& edit)
+{
+    notifySlots(&edit);
+}
+
+void ParameterRamper::flushAll()
+{
+    notifySlots(nullptr);
+}
+
+void ParameterRamper::cancel(te::AutomatableParameter& param)
+{
+    removeRamps([&param](const Ramp& r) { return r.param.get() == &param; }, false);
+}
+
+void ParameterRamper::cancelAll(te::Edit& edit)
+{
+    removeRamps([&edit](const Ramp& r) { return &r.plugin->edit == &edit; }, false);
+
+    // Move the last slot into each removed one. The references are released
+    // outside the lock, like removeRamps does.
+    Array<te::Plugin::Ptr> removedPlugins;
+    Array<te::AutomatableParameter::Ptr> removedParams;
+    const SpinLock::ScopedLockType sl(lock);
+    for (int i = numSlots; --i >= 0;) {
+        if (&slots[i].plugin->edit != &edit) continue;
+        Slot& last = slots[--numSlots];
+        removedPlugins.add(slots[i].plugin);
+        removedParams.add(slots[i].param);
+        slots[i].plugin = last.plugin;
+        slots[i].param = last.param;
+        slots[i].processorParam = last.processorParam;
+        slots[i].value.store(last.value.load());
+        slots[i].dirty.store(last.dirty.load());
+        slots[i].needsNotify = last.needsNotify;
+        last.plugin = nullptr;
+        last.param = nullptr;
+        last.processorParam = nullptr;
+        last.dirty.store(false);
+        last.needsNotify = false;
+    }
+}
+
+void ParameterRamper::removeRamps(std::function<bool(const Ramp&)> shouldRemove, bool notify)
+{
+    // Move the ramps out while holding the lock, and release the references
+    // after, so a plugin is never deleted while the audio thread waits.
+    if (ramps.isEmpty()) return; // only the message thread adds ramps
+    Array<Ramp> removed;
+    {
+        const SpinLock::ScopedLockType sl(lock);
+        for (int i = ramps.size(); --i >= 0;) {
+            if (!shouldRemove(ramps.getReference(i))) continue;
+            removed.add(ramps.getReference(i));
+            ramps.remove(i);
+        }
+    }
+    if (!notify) return;
+    // The audio thread only set the plugin's own parameter. Set the final
+    // value through the edit, so that the edit and any UI catch up.
+    for (auto& r : removed)
+        r.param->setNormalisedParameter(r.target, NotificationType::sendNotification);
+}
+
+void ParameterRamper::startTicking()
+{
+    if (isTimerRunning()) return;
+    lastTickMs = Time::getMillisecondCounterHiRes();
+    ticksSinceNotify = 0;
+    startTimerHz(tickHz);
+}
+
+bool ParameterRamper::isAudioRunning() const
+{
+    const double last = lastCallbackMs.load(std::memory_order_relaxed);
+    return last > 0 && Time::getMillisecondCounterHiRes() - last < stalledMs;
+}
+
+void ParameterRamper::timerCallback()
+{
+    const double nowMs = Time::getMillisecondCounterHiRes();
+    tick((nowMs - lastTickMs) / 1000.0);
+    lastTickMs = nowMs;
+
+    if (++ticksSinceNotify < tickHz / notifyHz) return;
+    ticksSinceNotify = 0;
+    removeRamps([](const Ramp& r) { return r.done; }, true);
+    notifySlots(nullptr);
+
+    // setValue and startRamp start it again
+    bool waiting = false;
+    for (int i = 0; i < numSlots && !waiting; i++) waiting = slots[i].needsNotify;
+    if (ramps.isEmpty() && !waiting) stopTimer();
+}
+
+void ParameterRamper::tick(double seconds)
+{
+    // While audio callbacks arrive, the audio thread drives the external
+    // plugins' parameters. Everything else is driven from here.
+    const bool audioRunning = isAudioRunning();
+    auto isDrivenHere = [audioRunning](AudioProcessorParameter* p) { return p == nullptr || !audioRunning; };
+
+    struct Change {
+        te::AutomatableParameter* param;
+        float value;
+        bool isSlot;
+    };
+    Array<Change> changes;
+    {
+        const SpinLock::ScopedLockType sl(lock);
+        for (int i = 0; i < numSlots; i++) {
+            Slot& s = slots[i];
+            if (!isDrivenHere(s.processorParam) || !s.dirty.exchange(false, std::memory_order_acquire)) continue;
+            s.needsNotify = false; // setting it below notifies
+            changes.add({ s.param.get(), s.value.load(std::memory_order_relaxed), true });
+        }
+        for (auto& r : ramps) {
+            if (r.done || !isDrivenHere(r.processorParam)) continue;
+            if (!r.started) {
+                r.started = true;
+                r.start = r.param->getCurrentNormalisedValue();
+            }
+            changes.add({ r.param.get(), advance(r, seconds), false });
+        }
+    }
+
+    // This writes the edit's ValueTree, so it happens outside the lock. The
+    // slots and ramps hold references, and only this thread removes them.
+    for (auto& c : changes) {
+        if (c.isSlot) c.param->beginParameterChangeGesture();
+        c.param->setNormalisedParameter(c.value, NotificationType::sendNotification);
+        if (c.isSlot) c.param->endParameterChangeGesture();
+    }
+}
+
+void ParameterRamper::notifySlots(te::Edit* edit)
+{
+    auto matches = [edit](const Slot& s) { return s.needsNotify && (!edit || &s.plugin->edit == edit); };
+    {
+        // The audio thread applies values while holding the lock, so once we
+        // have it, it is not part way through applying an old value. After
+        // this, it will not apply these values again, so a caller that
+        // changes the parameter next (like /plugin/state/set) is not undone.
+        const SpinLock::ScopedLockType sl(lock);
+        for (int i = 0; i < numSlots; i++)
+            if (matches(slots[i])) slots[i].dirty.store(false, std::memory_order_relaxed);
+    }
+
+    for (int i = 0; i < numSlots; i++) {
+        Slot& s = slots[i];
+        if (!matches(s)) continue;
+        s.needsNotify = false;
+        // If the audio thread already gave the plugin this value, this only
+        // brings the edit up to date. Otherwise it applies it too.
+        s.param->beginParameterChangeGesture();
+        s.param->setNormalisedParameter(s.value.load(std::memory_order_relaxed), NotificationType::sendNotification);
+        s.param->endParameterChangeGesture();
+    }
+}
+
+void ParameterRamper::audioDeviceAboutToStart(AudioIODevice* device)
+{
+    if (device) sampleRate = device->getCurrentSampleRate();
+}
+
+void ParameterRamper::audioDeviceStopped()
+{
+    // Hand everything to the message thread straight away
+    lastCallbackMs.store(0, std::memory_order_relaxed);
+}
+
+void ParameterRamper::audioDeviceIOCallback(const float**, int, float** outputChannelData,
+                                            int numOutputChannels, int numSamples)
+{
+    lastCallbackMs.store(Time::getMillisecondCounterHiRes(), std::memory_order_relaxed);
+
+    // The device manager adds our output to the other callbacks' output
+    for (int i = 0; i < numOutputChannels; i++)
+        if (outputChannelData[i]) FloatVectorOperations::clear(outputChannelData[i], numSamples);
+
+    const SpinLock::ScopedTryLockType tl(lock);
+    if (!tl.isLocked()) return; // try again next block
+
+    // Only the plugins' own parameters are set here. AutomatableParameters,
+    // and the edit behind them, belong to the message thread. Latest values
+    // first, so that a ramp started after a value wins.
+    for (int i = 0; i < numSlots; i++) {
+        Slot& s = slots[i];
+        if (s.processorParam && s.dirty.exchange(false, std::memory_order_acquire))
+            s.processorParam->setValue(s.value.load(std::memory_order_relaxed));
+    }
+
+    const double blockSeconds = numSamples / sampleRate.load();
+    for (auto& r : ramps) {
+        if (r.done || !r.processorParam) continue;
+        if (!r.started) {
+            r.started = true;
+            r.start = r.processorParam->getValue();
+        }
+        r.processorParam->setValue(advance(r, blockSeconds));
+    }
+}
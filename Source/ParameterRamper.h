@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    ParameterRamper.h
+    Created: 19 Oct 2026 1:07:42am
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <iostream>
+#include "../JuceLibraryCode/JuceHeader.h"
+
+namespace te = tracktion_engine;
+
+/** ParameterRamper moves plugin parameters smoothly to a target value, and
+ applies only the latest value of parameters that are set faster than they
+ can be used.
+
+ Ramps:  A client sends one /plugin/param/ramp message instead of a
+ stream of /plugin/param/set messages, and the parameter is updated at the
+ block rate, so the ramp is as smooth as the block size allows.
+
+ Threads: Setting an AutomatableParameter writes the edit's ValueTree, which
+ is only safe on the message thread. So the audio thread never touches one.
+ For external plugins, it sets the plugin's own AudioProcessorParameter once
+ per block, which hosts may do from any thread. Parameters of tracktion
+ plugins are set by a timer on the message thread, tickHz times a second.
+ That timer also takes over the external parameters when no audio callback
+ has arrived for stalledMs (no device, or a stopped one), so ramps always
+ finish, and the timer stops when there is nothing left to do.
+
+ Values: setValue stores the value in the parameter's slot, and it is applied
+ at the next block or tick. Values that are replaced before then are never
+ applied. Listeners of external parameters (the edit's ValueTree, automation
+ recording, any UI) are brought up to date by the same timer, at most
+ notifyHz times a second, so the cost on the message thread depends on the
+ number of parameters, not the number of messages. Anything that reads or
+ copies the edit (saving, rendering, getting or setting plugin state) must
+ call flush first, so it sees the latest values, and a waiting value cannot
+ overwrite what it does.
+
+ Ramps live in a preallocated array, guarded by a SpinLock. The audio thread
+ only tries the lock, and skips a block if the message thread holds it, so it
+ never waits. The audio thread never releases a reference: finished ramps are
+ collected by the timer, which also sends the change notification for the
+ final value.
+ */
+class ParameterRamper :
+    public AudioIODeviceCallback,
+    private Timer
+{
+public:
+    static constexpr int maxRamps = 256;
+    static constexpr int maxSlots = 256;
+    /** About the block rate of a typical device */
+    static constexpr int tickHz = 100;
+    static constexpr int notifyHz = 20;
+    static constexpr double stalledMs = 200;
+
+    ParameterRamper(AudioDeviceManager& deviceManager);
+    ~ParameterRamper();
+
+    /** Start a ramp from the current value to a normalised target value.
+     Replaces any ramp that is running on the same parameter. A curve of 0 is
+     linear. Positive curves start slowly and end quickly, negative curves do
+     the opposite. Returns false if too many ramps are running. Call on the
+     message thread. */
+    bool startRamp(te::Plugin& plugin, te::AutomatableParameter& param,
+                   float target, double durationSeconds, float curve);
+
+    /** Set a normalised value at the next audio block or tick. Cancels any
+     ramp on the parameter. Returns false if every slot is in use, and the
+     caller should set the parameter itself. Call on the message thread. */
+    bool setValue(te::Plugin& plugin, te::AutomatableParameter& param, float value);
+
+    /** Apply and notify every value that is waiting for a plugin in this
+     edit, and stop the audio thread from applying them again. Call on the
+     message thread. */
+    void flush(te::Edit& edit);
+    void flushAll();
+
+    /** Stop the ramp on this parameter, leaving it at its current value */
+    void cancel(te::AutomatableParameter& param);
+    /** Stop every ramp, and forget every slot, on a plugin in this edit. Call
+     before deleting the edit. */
+    void cancelAll(te::Edit& edit);
+
+    void audioDeviceIOCallback(const float** inputChannelData, int numInputChannels,
+                               float** outputChannelData, int numOutputChannels,
+                               int numSamples) override;
+    void audioDeviceAboutToStart(AudioIODevice* device) override;
+    void audioDeviceStopped() override;
+
+    /** 0 to 1, shaped by curve (-1 to 1) */
+    static float shape(float progress, float curve);
+
+private:
+    struct Ramp {
+        te::Plugin::Ptr plugin;
+        te::AutomatableParameter::Ptr param;
+        /** The external plugin's own parameter, which the audio thread sets.
+         nullptr for tracktion plugins. */
+        AudioProcessorParameter* processorParam = nullptr;
+        float target = 0, curve = 0;
+        double durationSeconds = 0;
+
+        // Used by whichever thread drives the ramp, while holding lock
+        bool started = false;
+        float start = 0;
+        double elapsedSeconds = 0;
+        bool done = false;
+    };
+
+    /** The latest value of one parameter. The message thread writes value,
+     then sets dirty. Whichever thread applies it clears dirty, then reads
+     value. */
+    struct Slot {
+        te::Plugin::Ptr plugin;
+        te::AutomatableParameter::Ptr param;
+        AudioProcessorParameter* processorParam = nullptr;
+        std::atomic<float> value { 0 };
+        std::atomic<bool> dirty { false };
+        bool needsNotify = false; // message thread only
+    };
+
+    void timerCallback() override;
+    void startTicking();
+    /** True while audio callbacks are arriving */
+    bool isAudioRunning() const;
+    /** Apply waiting values and advance ramps that the audio thread is not
+     driving. Call on the message thread. */
+    void tick(double seconds);
+    /** Apply and notify waiting values. If edit is not nullptr, only for
+     plugins in that edit. */
+    void notifySlots(te::Edit* edit);
+    /** Remove ramps where shouldRemove is true. Call on the message thread. */
+    void removeRamps(std::function<bool(const Ramp&)> shouldRemove, bool notify);
+    /** Move a started ramp on by some seconds, and return its new value. Call
+     while holding lock. */
+    static float advance(Ramp& ramp, double seconds);
+
+    AudioDeviceManager& deviceManager;
+    SpinLock lock;
+    Array<Ramp> ramps;
+    // Slots are added and removed on the message thread while holding lock
+    std::unique_ptr<Slot[]> slots;
+    int numSlots = 0;
+    std::atomic<double> sampleRate { 44100.0 };
+    /** When the last audio callback began, or 0 if the device stopped */
+    std::atomic<double> lastCallbackMs { 0 };
+    double lastTickMs = 0;
+    int ticksSinceNotify = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(ParameterRamper)
+};
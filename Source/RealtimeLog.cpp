@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    RealtimeLog.cpp
+    Created: 18 Oct 2026 5:47:09pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "RealtimeLog.h"
+
+RealtimeLog& RealtimeLog::getInstance()
+{
+    static RealtimeLog instance;
+    return instance;
+}
+
+RealtimeLog::RealtimeLog() : Thread("Realtime Log")
+{
+    cells.reset(new Cell[capacity]);
+    for (size_t i = 0; i < capacity; i++) cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+RealtimeLog::~RealtimeLog()
+{
+    stop();
+}
+
+void RealtimeLog::start()
+{
+    if (!isThreadRunning()) startThread(2);
+}
+
+void RealtimeLog::stop()
+{
+    stopThread(1000);
+    printPending();
+}
+
+void RealtimeLog::log(const char* message, std::initializer_list<double> values) noexcept
+{
+    Record r;
+    r.timeMs = Time::getMillisecondCounterHiRes();
+    r.message = message;
+    r.numValues = 0;
+    for (double v : values) {
+        if (r.numValues == maxValues) break;
+        r.values[r.numValues++] = v;
+    }
+    r.midiSize = 0;
+    if (!push(r)) numDropped++;
+}
+
+void RealtimeLog::logMidi(const char* message, const MidiMessage& midi, std::initializer_list<double> values) noexcept
+{
+    Record r;
+    r.timeMs = Time::getMillisecondCounterHiRes();
+    r.message = message;
+    r.numValues = 0;
+    for (double v : values) {
+        if (r.numValues == maxValues) break;
+        r.values[r.numValues++] = v;
+    }
+    r.midiSize = midi.getRawDataSize() <= 3 ? midi.getRawDataSize() : 0;
+    for (int i = 0; i < r.midiSize; i++) r.midi[i] = midi.getRawData()[i];
+    if (!push(r)) numDropped++;
+}
+
+bool RealtimeLog::push(const Record& record) noexcept
+{
+    Cell* cell;
+    size_t position = writePosition.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &cells[position & (capacity - 1)];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        auto difference = (intptr_t)sequence - (intptr_t)position;
+        if (difference == 0) {
+            // The cell is free. Claim it, unless another writer got there first.
+            if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        } else if (difference < 0) {
+            return false; // full
+        } else {
+            position = writePosition.load(std::memory_order_relaxed);
+        }
+    }
+    cell->record = record;
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool RealtimeLog::pop(Record& record) noexcept
+{
+    // Only the printing thread (or stop, after that thread has exited) reads
+    Cell* cell = &cells[readPosition & (capacity - 1)];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    if ((intptr_t)sequence - (intptr_t)(readPosition + 1) < 0) return false; // empty
+    record = cell->record;
+    cell->sequence.store(readPosition + capacity, std::memory_order_release);
+    readPosition++;
+    return true;
+}
+
+void RealtimeLog::run()
+{
+    while (!threadShouldExit()) {
+        printPending();
+        wait(20);
+    }
+}
+
+void RealtimeLog::printPending()
+{
+    Record r;
+    while (pop(r)) {
+        String line;
+        line << "[rt " << String(r.timeMs * 0.001, 4) << "] " << r.message;
+        if (r.midiSize > 0) line << " " << MidiMessage(r.midi, r.midiSize).getDescription();
+        for (int i = 0; i < r.numValues; i++) line << " " << r.values[i];
+        std::cout << line << std::endl;
+    }
+    int64 dropped = numDropped.exchange(0);
+    if (dropped > 0) std::cout << "[rt] Log ring was full. Dropped " << dropped << " records" << std::endl;
+}
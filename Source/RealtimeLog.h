@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    RealtimeLog.h
+    Created: 18 Oct 2026 5:47:09pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <iostream>
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** RealtimeLog lets code running on the audio or mixer threads print
+ diagnostics without taking locks, allocating, or making system calls.
+
+ Writers copy a fixed size Record into a preallocated ring. Any number of
+ threads may write at the same time (the ring is a bounded multi-producer queue
+ after Dmitry Vyukov's design). A background thread reads the records, formats
+ them, and prints them to stdout. If the ring is full, the record is dropped,
+ and the number of dropped records is printed later.
+
+ The message must be a string literal (or otherwise outlive the log), because
+ only the pointer is stored.
+
+     RealtimeLog::getInstance().log("Block too long", { blockMs, budgetMs });
+ */
+class RealtimeLog : private Thread {
+public:
+    static constexpr int maxValues = 4;
+
+    struct Record {
+        double timeMs;
+        const char* message;
+        double values[maxValues];
+        int numValues;
+        uint8 midi[3];
+        int midiSize;
+    };
+
+    static RealtimeLog& getInstance();
+
+    /** Start and stop the thread that prints records. Call on the message
+     thread. Records written while stopped wait in the ring. */
+    void start();
+    void stop();
+
+    /** Add a message with up to maxValues numbers. Safe on any thread. */
+    void log(const char* message, std::initializer_list<double> values = {}) noexcept;
+
+    /** Add a message that includes a short MIDI message. System exclusive
+     messages are not copied. Safe on any thread. */
+    void logMidi(const char* message, const MidiMessage& midi, std::initializer_list<double> values = {}) noexcept;
+
+private:
+    RealtimeLog();
+    ~RealtimeLog();
+
+    bool push(const Record& record) noexcept;
+    bool pop(Record& record) noexcept;
+    void run() override;
+    void printPending();
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    static constexpr size_t capacity = 8192; // must be a power of two
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> writePosition { 0 };
+    alignas(64) size_t readPosition = 0;
+    std::atomic<int64> numDropped { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(RealtimeLog)
+};
@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    RebuildCoalescer.cpp
+    Created: 19 Oct 2026 12:31:05am
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "RebuildCoalescer.h"
+#include "CybrLog.h"
+
+/** Counts changes to the edit's ValueTree while the window is open, so that a
+ window where nothing actually changed does not rebuild the graph */
+struct RebuildCoalescer::Pending : private ValueTree::Listener {
+    Pending(te::Edit& e) : edit(&e), state(e.state) { state.addListener(this); }
+    ~Pending() { state.removeListener(this); }
+
+    te::Edit* edit;
+    ValueTree state;
+    std::unique_ptr<te::TransportControl::ReallocationInhibitor> inhibitor;
+    double releaseAtMs = 0;
+    int numChanges = 0;
+
+private:
+    void valueTreePropertyChanged(ValueTree&, const Identifier&) override { numChanges++; }
+    void valueTreeChildAdded(ValueTree&, ValueTree&) override { numChanges++; }
+    void valueTreeChildRemoved(ValueTree&, ValueTree&, int) override { numChanges++; }
+    void valueTreeChildOrderChanged(ValueTree&, int, int) override { numChanges++; }
+};
+
+RebuildCoalescer::RebuildCoalescer()
+{
+}
+
+RebuildCoalescer::~RebuildCoalescer()
+{
+    flushAll();
+}
+
+void RebuildCoalescer::editWillChange(te::Edit& edit)
+{
+    // A stopped edit has no graph to glitch. Let tracktion rebuild as usual.
+    if (windowMs == 0 && !barAligned) return;
+    if (!edit.getTransport().isPlaying()) return;
+
+    for (auto* p : pending)
+        if (p->edit == &edit) return;
+
+    auto* p = pending.add(new Pending(edit));
+    p->inhibitor = std::make_unique<te::TransportControl::ReallocationInhibitor>(edit.getTransport());
+    p->releaseAtMs = getReleaseTimeMs(edit);
+    if (!isTimerRunning()) startTimer(5);
+}
+
+double RebuildCoalescer::getReleaseTimeMs(te::Edit& edit) const
+{
+    const double nowMs = Time::getMillisecondCounterHiRes();
+    if (!barAligned) return nowMs + windowMs;
+
+    // Wait for the next bar line, but never longer than a few seconds, in
+    // case the tempo is very slow.
+    auto& tempo = edit.tempoSequence;
+    const double now = edit.getTransport().getCurrentPosition();
+    const auto barsBeats = tempo.timeToBarsBeats(now);
+    const double nextBar = tempo.barsBeatsToTime({ barsBeats.bars + 1, 0.0 });
+    return nowMs + jlimit(0.0, 4000.0, (nextBar - now) * 1000.0);
+}
+
+void RebuildCoalescer::timerCallback()
+{
+    const double nowMs = Time::getMillisecondCounterHiRes();
+    for (int i = pending.size(); --i >= 0;) {
+        if (pending[i]->releaseAtMs > nowMs) continue;
+        release(*pending[i]);
+        pending.remove(i);
+    }
+    if (pending.isEmpty()) stopTimer();
+}
+
+void RebuildCoalescer::release(Pending& p)
+{
+    // Release the inhibitor first, so the rebuild is allowed
+    p.inhibitor = nullptr;
+    if (p.numChanges == 0) return;
+    p.edit->restartPlayback();
+    CYBR_LOG(server, debug, "RebuildCoalescer: " << p.numChanges << " changes in one rebuild");
+}
+
+void RebuildCoalescer::flush(te::Edit& edit)
+{
+    for (int i = pending.size(); --i >= 0;) {
+        if (pending[i]->edit != &edit) continue;
+        release(*pending[i]);
+        pending.remove(i);
+    }
+    if (pending.isEmpty()) stopTimer();
+}
+
+void RebuildCoalescer::flushAll()
+{
+    for (auto* p : pending) release(*p);
+    pending.clear();
+    stopTimer();
+}
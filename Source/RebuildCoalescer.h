@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    RebuildCoalescer.h
+    Created: 19 Oct 2026 12:31:05am
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <iostream>
+#include "../JuceLibraryCode/JuceHeader.h"
+
+namespace te = tracktion_engine;
+
+/** RebuildCoalescer turns a burst of structural edits into one playback graph
+ rebuild. While an edit is playing, every new clip, note list or plugin can
+ make tracktion reallocate the EditPlaybackContext's audio graph, and a burst
+ of them (like a live coded pattern arriving as a bundle of messages) causes a
+ burst of rebuilds and audible glitches.
+
+ Call editWillChange just before changing the structure of a playing edit
+ (adding tracks, clips, notes or plugins). Do not call it for lookups or
+ parameter changes. The first call opens a window, and holds a
+ TransportControl::ReallocationInhibitor until it closes. While the window is
+ open, changes to the edit's ValueTree are counted. When the window closes,
+ the inhibitor is released, and if anything changed, the graph is rebuilt
+ once with every change in it. The window is either a fixed time, or lasts
+ until the next bar line, so changes take effect on the beat.
+
+ Everything happens on the message thread.
+ */
+class RebuildCoalescer : private Timer {
+public:
+    RebuildCoalescer();
+    ~RebuildCoalescer();
+
+    /** Call on the message thread just before changing the structure of the
+     edit. Handlers that only look things up should not call this. */
+    void editWillChange(te::Edit& edit);
+
+    /** Rebuild now, if changes to this edit are waiting. Call before deleting
+     an edit. */
+    void flush(te::Edit& edit);
+    void flushAll();
+
+    /** Hold changes for this long. 0 rebuilds after every change, like
+     tracktion does without a coalescer. */
+    void setWindowMs(int ms) { windowMs = jmax(0, ms); }
+    /** Hold changes until the next bar line, instead of for a fixed time */
+    void setBarAligned(bool shouldAlign) { barAligned = shouldAlign; }
+
+    int getWindowMs() const { return windowMs; }
+    bool isBarAligned() const { return barAligned; }
+
+private:
+    struct Pending;
+    void timerCallback() override;
+    void release(Pending& pending);
+    double getReleaseTimeMs(te::Edit& edit) const;
+
+    OwnedArray<Pending> pending;
+    int windowMs = 50;
+    bool barAligned = false;
+
+    JUCE_DECLARE_NON_COPYABLE(RebuildCoalescer)
+};
@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    ServerStats.cpp
+    Created: 18 Oct 2026 11:14:51pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#include "ServerStats.h"
+
+void ServerStats::Histogram::add(double micros)
+{
+    micros = jmax(0.0, micros);
+    const int bucket = jlimit(0, numBuckets - 1, (int)std::log2(jmax(1.0, micros)));
+    const uint64 whole = (uint64)micros;
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    totalMicros.fetch_add(whole, std::memory_order_relaxed);
+
+    uint64 previous = maxMicros.load(std::memory_order_relaxed);
+    while (whole > previous && !maxMicros.compare_exchange_weak(previous, whole, std::memory_order_relaxed)) {}
+}
+
+void ServerStats::Histogram::reset()
+{
+    for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+    totalMicros.store(0, std::memory_order_relaxed);
+    maxMicros.store(0, std::memory_order_relaxed);
+}
+
+double ServerStats::Histogram::getMeanMicros() const
+{
+    const uint64 n = getCount();
+    return n > 0 ? (double)totalMicros.load(std::memory_order_relaxed) / (double)n : 0.0;
+}
+
+double ServerStats::Histogram::getMaxMicros() const
+{
+    return (double)maxMicros.load(std::memory_order_relaxed);
+}
+
+double ServerStats::Histogram::getPercentileMicros(double p) const
+{
+    // Sum the buckets instead of trusting count, which may be a little ahead
+    // of the buckets while another thread is adding.
+    uint64 counts[numBuckets], total = 0;
+    for (int i = 0; i < numBuckets; i++) total += (counts[i] = buckets[i].load(std::memory_order_relaxed));
+    if (total == 0) return 0.0;
+
+    const double target = p * (double)total;
+    uint64 cumulative = 0;
+    for (int i = 0; i < numBuckets; i++) {
+        cumulative += counts[i];
+        if ((double)cumulative >= target) return jmin(getMaxMicros(), std::exp2(i + 1.0));
+    }
+    return getMaxMicros();
+}
+
+var ServerStats::Histogram::toVar() const
+{
+    auto* obj = new DynamicObject();
+    var result(obj);
+    obj->setProperty("count", (int64)getCount());
+    obj->setProperty("mean", getMeanMicros());
+    obj->setProperty("p50", getPercentileMicros(0.5));
+    obj->setProperty("p99", getPercentileMicros(0.99));
+    obj->setProperty("p999", getPercentileMicros(0.999));
+    obj->setProperty("max", getMaxMicros());
+    return result;
+}
+
+//==============================================================================
+ServerStats::ServerStats() :
+    addresses(new AddressStats[maxAddresses])
+{
+    reset();
+}
+
+ServerStats::AddressStats* ServerStats::findOrAdd(const String& address)
+{
+    uint32 hash = (uint32)address.hashCode();
+    if (hash == 0) hash = 1;
+    char truncated[maxAddressLength];
+    address.copyToUTF8(truncated, maxAddressLength);
+
+    // Open addressing with linear probing. Slots are never removed (reset
+    // only clears the counters), so a probe can stop at the first empty slot.
+    for (int i = 0; i < maxAddresses; i++) {
+        AddressStats& slot = addresses[(hash + (uint32)i) % maxAddresses];
+        const uint32 slotHash = slot.hash.load(std::memory_order_acquire);
+        if (slotHash == 0) {
+            std::memcpy(slot.address, truncated, maxAddressLength);
+            slot.hash.store(hash, std::memory_order_release);
+            return &slot;
+        }
+        if (slotHash == hash && std::strncmp(slot.address, truncated, maxAddressLength) == 0) return &slot;
+    }
+    return nullptr;
+}
+
+void ServerStats::record(const String& address, Outcome outcome, double handlerMicros)
+{
+    AddressStats* stats = findOrAdd(address);
+    if (!stats) {
+        untracked.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    stats->messages.fetch_add(1, std::memory_order_relaxed);
+    if (outcome == Outcome::error) stats->errors.fetch_add(1, std::memory_order_relaxed);
+    if (outcome == Outcome::dropped) stats->dropped.fetch_add(1, std::memory_order_relaxed);
+    stats->handler.add(handlerMicros);
+}
+
+void ServerStats::reset()
+{
+    for (int i = 0; i < maxAddresses; i++) {
+        AddressStats& slot = addresses[i];
+        slot.messages.store(0, std::memory_order_relaxed);
+        slot.errors.store(0, std::memory_order_relaxed);
+        slot.dropped.store(0, std::memory_order_relaxed);
+        slot.handler.reset();
+    }
+    untracked.store(0, std::memory_order_relaxed);
+    coalesced.store(0, std::memory_order_relaxed);
+    queueDelay.reset();
+}
+
+var ServerStats::toVar() const
+{
+    struct Entry { const AddressStats* stats; double totalMicros; };
+    Array<Entry> entries;
+    for (int i = 0; i < maxAddresses; i++) {
+        const AddressStats& slot = addresses[i];
+        if (slot.hash.load(std::memory_order_acquire) == 0) continue;
+        if (slot.messages.load(std::memory_order_relaxed) == 0) continue;
+        entries.add({ &slot, slot.handler.getMeanMicros() * (double)slot.handler.getCount() });
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.totalMicros > b.totalMicros; });
+
+    Array<var> list;
+    for (auto& e : entries) {
+        auto* obj = new DynamicObject();
+        obj->setProperty("address", String::fromUTF8(e.stats->address));
+        obj->setProperty("messages", (int64)e.stats->messages.load(std::memory_order_relaxed));
+        obj->setProperty("errors", (int64)e.stats->errors.load(std::memory_order_relaxed));
+        obj->setProperty("dropped", (int64)e.stats->dropped.load(std::memory_order_relaxed));
+        obj->setProperty("handler", e.stats->handler.toVar());
+        list.add(var(obj));
+    }
+
+    auto* obj = new DynamicObject();
+    var result(obj);
+    obj->setProperty("queueDelay", queueDelay.toVar());
+    obj->setProperty("untracked", (int64)untracked.load(std::memory_order_relaxed));
+    obj->setProperty("coalesced", (int64)coalesced.load(std::memory_order_relaxed));
+    obj->setProperty("addresses", list);
+    return result;
+}
+
+void ServerStats::sendTo(OSCSender& sender) const
+{
+    // Build the bundle from toVar, so both formats always agree
+    var stats = toVar();
+    auto histogramArgs = [](OSCMessage& m, const var& h) {
+        m.addInt32((int32)(int64)h["count"]);
+        m.addFloat32((float)(double)h["mean"]);
+        m.addFloat32((float)(double)h["p50"]);
+        m.addFloat32((float)(double)h["p99"]);
+        m.addFloat32((float)(double)h["max"]);
+    };
+
+    OSCBundle bundle;
+    OSCMessage queue{ OSCAddressPattern("/stats/queue") };
+    histogramArgs(queue, stats["queueDelay"]);
+    queue.addInt32((int32)(int64)stats["untracked"]);
+    queue.addInt32((int32)(int64)stats["coalesced"]);
+    bundle.addElement(OSCBundle::Element(queue));
+
+    // Stay well under the UDP packet size. The slowest addresses come first.
+    const int maxMessages = 200;
+    const var& list = stats["addresses"];
+    for (int i = 0; i < jmin(list.size(), maxMessages); i++) {
+        const var& a = list[i];
+        OSCMessage m{ OSCAddressPattern("/stats/address") };
+        m.addString(a["address"].toString());
+        m.addInt32((int32)(int64)a["messages"]);
+        m.addInt32((int32)(int64)a["errors"]);
+        m.addInt32((int32)(int64)a["dropped"]);
+        histogramArgs(m, a["handler"]);
+        bundle.addElement(OSCBundle::Element(m));
+    }
+    sender.send(bundle);
+}
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    ServerStats.h
+    Created: 18 Oct 2026 11:14:51pm
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <iostream>
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** ServerStats counts what FluidOscServer does with each OSC address, and how
+ long it takes. Recording is a few relaxed atomic increments, so it is cheap
+ enough to leave on during a performance. Nothing is allocated after the
+ constructor, and nothing is locked.
+
+ Addresses are recorded on the message thread. The statistics may be read
+ from any thread, while they are being recorded.
+
+ Durations are kept in histograms with power of two buckets, in microseconds.
+ Bucket i counts durations from 2^i to 2^(i+1) microseconds, so percentiles
+ are accurate to within a factor of two, which is enough to find a slow
+ handler.
+ */
+class ServerStats {
+public:
+    enum class Outcome {
+        handled,
+        error,   // no handler for the address, or the handler threw
+        dropped  // ignored, because there was no edit to apply it to
+    };
+
+    class Histogram {
+    public:
+        static constexpr int numBuckets = 26; // up to about a minute
+        void add(double micros);
+        void reset();
+        uint64 getCount() const { return count.load(std::memory_order_relaxed); }
+        double getMeanMicros() const;
+        double getMaxMicros() const;
+        /** The upper bound of the bucket that contains percentile p (0-1) */
+        double getPercentileMicros(double p) const;
+        /** { "count", "mean", "p50", "p99", "p999", "max" } in microseconds */
+        var toVar() const;
+
+    private:
+        std::atomic<uint32> buckets[numBuckets] {};
+        std::atomic<uint64> count { 0 };
+        std::atomic<uint64> totalMicros { 0 };
+        std::atomic<uint64> maxMicros { 0 };
+    };
+
+    ServerStats();
+
+    /** Call on the message thread after handling a message */
+    void record(const String& address, Outcome outcome, double handlerMicros);
+    /** Time from when the receiver thread got a packet to when the message
+     thread began handling it */
+    void recordQueueDelay(double micros) { queueDelay.add(micros); }
+    /** A /plugin/param/set replaced an older value before it was handled */
+    void recordCoalesced() { coalesced.fetch_add(1, std::memory_order_relaxed); }
+    void reset();
+
+    /** { "queueDelay": {...}, "untracked": 0, "coalesced": 0, "addresses": [{ "address": "/midiclip/n",
+     "messages": 10, "errors": 0, "dropped": 0, "handler": {...} }] }
+     Addresses are sorted by the total time spent in their handler. */
+    var toVar() const;
+
+    /** Send the statistics as a bundle of /stats/queue and /stats/address messages */
+    void sendTo(OSCSender& sender) const;
+
+private:
+    static constexpr int maxAddresses = 256;
+    static constexpr int maxAddressLength = 64;
+
+    struct AddressStats {
+        // 0 while the slot is unused. Written after the address, so a reader
+        // that sees a hash can read the address.
+        std::atomic<uint32> hash { 0 };
+        char address[maxAddressLength] {};
+        std::atomic<uint64> messages { 0 }, errors { 0 }, dropped { 0 };
+        Histogram handler;
+    };
+
+    AddressStats* findOrAdd(const String& address);
+
+    std::unique_ptr<AddressStats[]> addresses;
+    std::atomic<uint64> untracked { 0 }; // messages to addresses that did not fit
+    std::atomic<uint64> coalesced { 0 };
+    Histogram queueDelay;
+
+    JUCE_DECLARE_NON_COPYABLE(ServerStats)
+};
@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    StreamClock.h
+    Created: 18 Oct 2026 11:40:05am
+    Author:  Charles Holbrow
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cmath>
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** StreamClock maps host time (Time::getMillisecondCounterHiRes) to the
+ engine's streamTime.
+
+ The audio callback runs once per block, but it does not run at exactly the
+ same interval every time, so reading the host clock from inside the callback
+ is noisy. StreamClock smooths the host time of each block with a second order
+ delay-locked loop, as described by Fons Adriaensen in "Using a DLL to filter
+ time". streamTime itself is derived from a sample count, so it is already
+ smooth. The result is an offset that can be added to any host time to get the
+ matching streamTime.
+
+ update() should only be called from the audio thread. getAdjustSecs may be
+ called from any thread.
+ */
+class StreamClock {
+public:
+    /** bandwidth is the loop bandwidth in Hz. Lower values reject more jitter,
+     but take longer to follow real drift between the clocks. */
+    StreamClock(double bandwidth = 0.5) : bandwidthHz(bandwidth) {}
+
+    /** Call once at the start of each block. streamTime is the start of the
+     block, and hostSecs is the host time at which the callback happened. */
+    void update(double streamTime, double hostSecs) {
+        if (!hasStarted) {
+            // We need two blocks to measure the period. Until then, use the
+            // unfiltered offset.
+            hasStarted = true;
+            lastStreamTime = streamTime;
+            atomicAdjustSecs = streamTime - hostSecs;
+            return;
+        }
+
+        double period = streamTime - lastStreamTime;
+        lastStreamTime = streamTime;
+
+        // Reset the loop on the second block, when the block size changes, or
+        // when the stream jumps (for example when the device restarts).
+        if (!initialised || period <= 0 || std::abs(period - nominalPeriod) > nominalPeriod * 0.01) {
+            reset(streamTime, hostSecs, period);
+            return;
+        }
+
+        double error = hostSecs - t1;
+        if (std::abs(error) > maxErrorSecs) {
+            // The callback was stalled for a very long time. Don't let that
+            // drag the estimate around. Start over instead.
+            reset(streamTime, hostSecs, period);
+            return;
+        }
+
+        t0 = t1;
+        t1 += b * error + e2;
+        e2 += c * error;
+        atomicAdjustSecs = streamTime - t0;
+    }
+
+    /** Add this to a host time in seconds to get the streamTime */
+    double getAdjustSecs() const { return atomicAdjustSecs; }
+
+    /** The filtered estimate of the duration of one block, in seconds */
+    double getPeriod() const { return e2; }
+
+private:
+    void reset(double streamTime, double hostSecs, double period) {
+        if (period <= 0 || period > 1.0) period = nominalPeriod > 0 ? nominalPeriod : 0.01;
+        nominalPeriod = period;
+
+        double omega = 2.0 * MathConstants<double>::pi * bandwidthHz * period;
+        b = std::sqrt(2.0) * omega;
+        c = omega * omega;
+
+        e2 = period;
+        t0 = hostSecs;
+        t1 = t0 + e2;
+        initialised = true;
+        atomicAdjustSecs = streamTime - t0;
+    }
+
+    double bandwidthHz;
+    double maxErrorSecs = 0.25;
+
+    bool hasStarted = false;
+    bool initialised = false;
+    double lastStreamTime = 0;
+    double nominalPeriod = 0;
+
+    // Loop state, named as in the paper
+    double b = 0, c = 0;
+    double e2 = 0, t0 = 0, t1 = 0;
+
+    std::atomic<double> atomicAdjustSecs { 0 };
+};
@@ -14,6 +14,8 @@
 // For now, just use a simple test message. Later we can figure out if and how
 // to subclass or DRY these.
 struct TimestampedTest {
+    /** When the message was sent, if the sender used a timetag. Otherwise,
+     when the message arrived. */
     double arrivedAt = 0;
     double streamTime = 0;
     double editTime = 0;
@@ -27,19 +29,24 @@ struct TimestampedTest {
     }
 };
 
-/** LockFreeOscMessageQueue helps efficiently pass messages between threads.
+/** A MIDI message converted from OSC, waiting to be played by the live input
+ node. `streamTime` is the time at which the message should be heard. */
+struct TimestampedMidi {
+    double arrivedAt = 0;
+    double streamTime = 0;
+    double editTime = 0;
+
+    MidiMessage message;
+};
+
+/** LockFreeQueue helps efficiently pass objects between exactly one writer
+ thread and exactly one reader thread. When the queue is full, the oldest
+ objects are thrown away to make room for new ones.
  */
-class LockFreeOscMessageQueue {
+template <typename ObjectType, int SIZE = 4096>
+class LockFreeQueue {
 public:
-    void writeMessage(const OSCMessage& message, double timeMs) {
-        // Create the object
-        if (message.size() < 1) return;
-        if (!message[0].isInt32()) return;
-        TimestampedTest obj{ timeMs * 0.001, 0.0, 0.0, message[0].getInt32() };
-        writeMessage(obj);
-    }
-
-    void writeMessage(TimestampedTest obj) {
+    void writeMessage(ObjectType obj) {
         // write to QUEUE
         int start1, size1, start2, size2;
         abstractFifo.prepareToWrite(1, start1, size1, start2, size2);
@@ -56,7 +63,8 @@ public:
             // buffer away. 10 was chosen arbitrarily.
             abstractFifo.prepareToRead(10, start1, size1, start2, size2);
             abstractFifo.finishedRead(size1 + size2);
-            
+            lostMessages = true;
+
             // write to QUEUE should be identical to above
             abstractFifo.prepareToWrite(1, start1, size1, start2, size2);
             if (size1 > 0) storage[start1] = obj;
@@ -65,33 +73,55 @@ public:
         }
     }
 
-    std::vector<TimestampedTest> read() {
+    std::vector<ObjectType> read() {
         // temporary storage for received values
         // is std::vector the right container?
-        std::vector<TimestampedTest> received;
-        
+        std::vector<ObjectType> received;
+        received.reserve(abstractFifo.getNumReady());
+        readInto(received);
+        return received;
+    }
+
+    /** Append everything in the queue to `dest`. This does not allocate as
+     long as `dest` has enough capacity, so it is safe to call from the audio
+     thread if the vector was reserved in advance. */
+    void readInto(std::vector<ObjectType>& dest) {
         // Handle lock free queue
         int start1, size1, start2, size2;
-        abstractFifo.prepareToRead(abstractFifo.getNumReady(), start1, size1, start2, size2);
-        received.reserve(size1+size2);
+        int numToRead = jmin(abstractFifo.getNumReady(), (int)(dest.capacity() - dest.size()));
+        abstractFifo.prepareToRead(numToRead, start1, size1, start2, size2);
 
-        for (int i = start1; i < start1 + size1; i++) {
-            auto& obj = storage[i];
-            received.push_back(obj);
-        }
-        for (int i = start2; i < start2 + size2; i++) {
-            auto& obj = storage[i];
-            received.push_back(obj);
-        }
+        for (int i = start1; i < start1 + size1; i++) dest.push_back(storage[i]);
+        for (int i = start2; i < start2 + size2; i++) dest.push_back(storage[i]);
 
         abstractFifo.finishedRead(size1 + size2);
-
-        return received;
     }
 
+    int getNumReady() const { return abstractFifo.getNumReady(); }
+
+    /** Returns true (once) if messages were thrown away since the last call */
+    bool checkAndClearLostMessages() { return lostMessages.exchange(false); }
+
 private:
     std::atomic<bool> lostMessages{false};
-    static const int SIZE = 4096;
     AbstractFifo abstractFifo{SIZE};
-    TimestampedTest storage[SIZE];
+    ObjectType storage[SIZE];
 };
+
+/** LockFreeOscMessageQueue helps efficiently pass messages between threads.
+ */
+class LockFreeOscMessageQueue : public LockFreeQueue<TimestampedTest> {
+public:
+    using LockFreeQueue<TimestampedTest>::writeMessage;
+
+    void writeMessage(const OSCMessage& message, double timeMs) {
+        // Create the object
+        if (message.size() < 1) return;
+        if (!message[0].isInt32()) return;
+        TimestampedTest obj{ timeMs * 0.001, 0.0, 0.0, message[0].getInt32() };
+        writeMessage(obj);
+    }
+};
+
+/** Pass MIDI messages converted from OSC between threads */
+using LockFreeMidiMessageQueue = LockFreeQueue<TimestampedMidi>;
@@ -10,10 +10,19 @@
 
 #include "cybr_helpers.h"
 
+static void logMissingPlugins(te::Edit& edit)
+{
+    for (auto plugin : edit.getPluginCache().getPlugins()) {
+        if (plugin->isMissing()) {
+            CYBR_LOG(edit, warn, "Edit contains this plugin, which is missing from the host: " << plugin->getName());
+        }
+    }
+}
+
 // Creates a new edit, and leaves deletion up to you
 te::Edit* createEmptyEdit(File inputFile, te::Engine& engine)
 {
-    std::cout << "Creating Edit Object" << std::endl;
+    CYBR_LOG(edit, info, "Creating Edit Object");
     te::Edit::Options editOptions{ engine };
     editOptions.editProjectItemID = te::ProjectItemID::createNewID(0);
     editOptions.editState = te::createEmptyEdit();
@@ -31,7 +40,7 @@ te::Edit* createEdit(File inputFile, te::Engine& engine) {
     // Create the edit object.
     // Note we cannot save an edit file without and ediit file retriever. It is
     // also used resolves audioclips that have source='./any/relative/path.wav'.
-    std::cout << "Creating Edit Object" << std::endl;
+    CYBR_LOG(edit, info, "Creating Edit Object");
     te::Edit::Options editOptions{ engine };
     editOptions.editProjectItemID = te::ProjectItemID::createNewID(0);
     editOptions.editState = valueTree;
@@ -44,14 +53,8 @@ te::Edit* createEdit(File inputFile, te::Engine& engine) {
     // have a source property with an absolute path value. We want to avoid
     // clip sources with project ids or relative path values.
     setClipSourcesToDirectFileReferences(*newEdit, false, true);
-    
-    // List any missing plugins
-    for (auto plugin : newEdit->getPluginCache().getPlugins()) {
-        if (plugin->isMissing()) {
-            std::cout << "WARNING! Edit contains this plugin, which is missing from the host: " << plugin->getName() << std::endl;
-        }
-    }
-    std::cout << "Loaded edit file: " << inputFile.getFullPathName() << std::endl << std::endl;
+    logMissingPlugins(*newEdit);
+    CYBR_LOG(edit, info, "Loaded edit file: " << inputFile.getFullPathName());
     return newEdit;
 }
 
@@ -73,12 +76,64 @@ CybrEdit* copyCybrEditForPlayback(CybrEdit& cybrEdit) {
     return newCybrEdit;
 }
 
+CybrEdit* loadCybrEditForPlayback(File file, te::Engine& engine) {
+    const bool exists = file.existsAsFile();
+    te::Edit::Options options{ engine };
+    options.editState = exists ? te::loadEditFromFile(file, te::ProjectItemID::createNewID(0)) : te::createEmptyEdit();
+    options.role = te::Edit::EditRole::forEditing;
+    options.editProjectItemID = te::ProjectItemID::createNewID(0);
+    options.numUndoLevelsToStore = 0;
+    options.editFileRetriever = [file] { return file; };
+    te::Edit* newEdit = new te::Edit(options);
+    if (exists) {
+        setClipSourcesToDirectFileReferences(*newEdit, false, true);
+        logMissingPlugins(*newEdit);
+        CYBR_LOG(edit, info, "Loaded edit file: " << file.getFullPathName());
+    }
+    newEdit->initialiseAllPlugins();
+    newEdit->getTransport().position = 0;
+    return new CybrEdit(newEdit);
+}
+
+te::Edit* copyEditForRendering(te::Edit& source) {
+    te::Edit::Options options{ source.engine };
+    options.editState = source.state.createCopy();
+    options.role = te::Edit::forRendering;
+    options.editProjectItemID = te::ProjectItemID::createNewID(0);
+    options.numUndoLevelsToStore = 0;
+    options.editFileRetriever = source.editFileRetriever;
+    return new te::Edit(options);
+}
+
+std::unique_ptr<te::Renderer::RenderTask> createRenderTask(te::Edit& edit, const File& wavFile, const String& description) {
+    te::Renderer::Parameters params(edit);
+    params.time = { 0.0, edit.getLength() };
+    params.usePlugins = true;
+    // Otherwise the master track's plugins (like the LoudnessTapPlugin that
+    // EditAnalysis adds) are left out of the render
+    params.useMasterPlugins = true;
+    int trackCount = te::getAllTracks(edit).size();
+    for (int i = 0; i < trackCount; i++) params.tracksToDo.setBit(i);
+
+    if (wavFile != File()) {
+        wavFile.getParentDirectory().createDirectory();
+        params.destFile = wavFile;
+        params.audioFormat = edit.engine.getAudioFileFormatManager().getWavFormat();
+        params.bitDepth = 24;
+    } else {
+        params.destFile = File();
+        params.audioFormat = nullptr;
+    }
+    // The task builds its audio graph here
+    return std::make_unique<te::Renderer::RenderTask>(description, params, nullptr, nullptr);
+}
+
 void setClipSourcesToDirectFileReferences(te::Edit& changeEdit, bool useRelativePath, bool verbose = true)
 {
     int failures = 0;
-    if (verbose) std::cout << "Searching for audio clips and updating their sources to "
+    if (verbose) CYBR_LOG(edit, info, "Searching for audio clips and updating their sources to "
         << (useRelativePath ? "relative" : "absolute")
-        << " file paths" << std::endl;
+        << " file paths");
     
     for (auto track : te::getClipTracks(changeEdit)) { // for each track
         for (auto clip : track->getClips()) { // inspect each clip
@@ -88,9 +143,8 @@ void setClipSourcesToDirectFileReferences(te::Edit& changeEdit, bool useRelative
                 if (file == File()) {
                     // We failed to get the filepath from the project manager
                     failures++;
-                    std::cerr
-                    << "ERROR: Failed to find and update source clip: " << audioClip->getName()
-                    << " source=\"" << sourceFileRef.source << "\"" << std::endl;
+                    CYBR_LOG(edit, error, "Failed to find and update source clip: " << audioClip->getName()
+                    << " source=\"" << sourceFileRef.source << "\"");
                 }
                 else {
                     // We have a filepath. We are not certain the file exists.
@@ -107,26 +161,23 @@ void setClipSourcesToDirectFileReferences(te::Edit& changeEdit, bool useRelative
                     sourceFileRef.setToDirectFileReference(file, useRelativePath); // assertion breakpoint if edit file DNE
                     if (original != sourceFileRef.source) {
                         audioClip->sourceMediaChanged(); // what does this really do, and is it needed?
-                        if (verbose) std::cout
-                            << "Updated \"" << original
-                            << "\" to \"" << sourceFileRef.source << "\"" << std::endl;
+                        if (verbose) CYBR_LOG(edit, info, "Updated \"" << original
+                            << "\" to \"" << sourceFileRef.source << "\"");
                     }
                     else {
-                        if (verbose) std::cout
-                            << "Unchanged path: " << sourceFileRef.source << std::endl;
+                        if (verbose) CYBR_LOG(edit, info, "Unchanged path: " << sourceFileRef.source);
                     }
                 }
             }
         }
     }
     if (failures > 0) {
-        std::cerr
-        << "ERROR: not all source clips could be identified!" << std::endl
+        CYBR_LOG(edit, error, "not all source clips could be identified!" << std::endl
         << "In my testing on windows, this happens when any of the following are true:" << std::endl
         << "- App is not aware of the project manager (try --autodetect-pm)" << std::endl
-        << "- The uid is not found by the project manager" << std::endl;
+        << "- The uid is not found by the project manager");
     }
-    if (verbose) std::cout << std::endl;
+    if (verbose) CYBR_LOG(edit, info, "");
 }
 
 void autodetectPmSettings(te::Engine& engine)
@@ -141,17 +192,17 @@ void autodetectPmSettings(te::Engine& engine)
     .getChildFile("Waveform")
     .getChildFile("Waveform.settings");
     
-    std::cout << "Looking for Waveform settings: " << file.getFullPathName() << std::endl;
+    CYBR_LOG(general, info, "Looking for Waveform settings: " << file.getFullPathName());
     if (!file.existsAsFile())
     {
-        std::cout << "Waveform settings not found" << std::endl;
+        CYBR_LOG(general, warn, "Waveform settings not found");
     }
     else
     {
-        std::cout << "Found Waveform settings" << std::endl;
+        CYBR_LOG(general, info, "Found Waveform settings");
         XmlDocument parser(file);
         std::unique_ptr<XmlElement> xml(parser.getDocumentElement());
-        if (xml == nullptr) std::cout << "Failed to parse Waveform.settings" << std::endl;
+        if (xml == nullptr) CYBR_LOG(general, warn, "Failed to parse Waveform.settings");
         
         ValueTree folders;
         folders = ValueTree::fromXml(*xml);
@@ -167,16 +218,14 @@ void autodetectPmSettings(te::Engine& engine)
                     // - te::IDs::LIBRARY
                     // - te::IDs::ACTIVE
                     te::ProjectManager::getInstance()->folders = folders;
-                    std::cout
-                    << "LIBRARY uid: " << folders.getChildWithName(te::IDs::LIBRARY).getProperty("uid").toString() << std::endl
-                    << "ACTIVE uid:  " << folders.getChildWithName(te::IDs::ACTIVE).getProperty("uid").toString() << std::endl
-                    << std::endl;
+                    CYBR_LOG(general, info, "LIBRARY uid: " << folders.getChildWithName(te::IDs::LIBRARY).getProperty("uid").toString() << std::endl
+                    << "ACTIVE uid:  " << folders.getChildWithName(te::IDs::ACTIVE).getProperty("uid").toString());
                     return;
                 }
             }
         }
     }
-    std::cout << "Failed to load Tracktion Waveform settings from: " << file.getFullPathName() << std::endl << std::endl;
+    CYBR_LOG(general, warn, "Failed to load Tracktion Waveform settings from: " << file.getFullPathName());
     return;
 }
 
@@ -224,7 +273,7 @@ void listMidiDevices(te::Engine& engine) {
 
 void scanVst3(te::Engine& engine)
 {
-    std::cout << "Scanning for VST3 plugins..." << std::endl;
+    CYBR_LOG(plugin, info, "Scanning for VST3 plugins...");
     
     juce::VST3PluginFormat vst3;
     juce::String deadPlugins;
@@ -238,21 +287,21 @@ void scanVst3(te::Engine& engine)
     
     juce::String pluginName;
     do {
-        std::cout << "Scanning: \"" << pluginScanner.getNextPluginFileThatWillBeScanned() << "\"" << std::endl;
+        CYBR_LOG(plugin, info, "Scanning: \"" << pluginScanner.getNextPluginFileThatWillBeScanned() << "\"");
     } while (pluginScanner.scanNextFile(true, pluginName));
     
     // log failures
-    std::cout << "Dead Plugins: " << deadPlugins << std::endl << std::endl;
+    CYBR_LOG(plugin, info, "Dead Plugins: " << deadPlugins);
     for (auto filename : pluginScanner.getFailedFiles()) {
-        std::cout << "Failed to load plugin: " << filename << std::endl;
+        CYBR_LOG(plugin, warn, "Failed to load plugin: " << filename);
     }
-    std::cout << std::endl;
+    CYBR_LOG(plugin, info, "");
 }
 
 void scanVst2(te::Engine& engine) {
 #if JUCE_PLUGINHOST_VST
     juce::VSTPluginFormat vst2;
-    std::cout << "Scanning for VST2 plugins in: " << vst2.getDefaultLocationsToSearch().toString() << std::endl;
+    CYBR_LOG(plugin, info, "Scanning for VST2 plugins in: " << vst2.getDefaultLocationsToSearch().toString());
     
     juce::String deadPlugins;
     juce::PluginDirectoryScanner pluginScanner{
@@ -265,17 +314,17 @@ void scanVst2(te::Engine& engine) {
     
     juce::String pluginName;
     do {
-        std::cout << "Scanning: \"" << pluginScanner.getNextPluginFileThatWillBeScanned() << "\"" << std::endl;
+        CYBR_LOG(plugin, info, "Scanning: \"" << pluginScanner.getNextPluginFileThatWillBeScanned() << "\"");
     } while (pluginScanner.scanNextFile(true, pluginName));
     
     // log failures
-    std::cout << "Dead Plugins: " << deadPlugins << std::endl << std::endl;
+    CYBR_LOG(plugin, info, "Dead Plugins: " << deadPlugins);
     for (auto filename : pluginScanner.getFailedFiles()) {
-        std::cout << "Failed to load plugin: " << filename << std::endl;
+        CYBR_LOG(plugin, warn, "Failed to load plugin: " << filename);
     }
-    std::cout << std::endl;
+    CYBR_LOG(plugin, info, "");
 #else
-    std::cout << "VST 2 hosting is not enabled in the projucer project. Skipping VST 2 scan." << std::endl;
+    CYBR_LOG(plugin, warn, "VST 2 hosting is not enabled in the projucer project. Skipping VST 2 scan.");
     return;
 #endif
 }
@@ -338,7 +387,7 @@ void listPluginParameters(te::Engine& engine, const String pluginName) {
     te::AudioTrack* track = te::getFirstAudioTrack(*edit);
     te::Plugin* plugin = getOrCreatePluginByName(*track, pluginName);
     if (!plugin) {
-        std::cout << "Plugin not found: " << pluginName << std::endl;
+        CYBR_LOG(plugin, warn, "Plugin not found: " << pluginName);
         return;
     }
     // internal plugin parameters may not appear in this list. (chorus)
@@ -353,7 +402,7 @@ void listPluginPresets(te::Engine& engine, const String pluginName) {
     te::AudioTrack* track = te::getFirstAudioTrack(*edit);
     te::Plugin* plugin = getOrCreatePluginByName(*track, pluginName);
     if (!plugin) {
-        std::cout << "Plugin not found: " << pluginName << std::endl;
+        CYBR_LOG(plugin, warn, "Plugin not found: " << pluginName);
         return;
     }
     if (auto extPlugin = dynamic_cast<te::ExternalPlugin*>(plugin)) {
@@ -374,19 +423,77 @@ void listPluginPresets(te::Engine& engine, const String pluginName) {
 
 void printPreset(te::Plugin* plugin) {
     if (!plugin) return;
+    if (dynamic_cast<te::ExternalPlugin*>(plugin)) {
+        MemoryBlock mb = getPluginState(plugin);
+        std::cout << "Plugin state: " << std::endl << mb.toBase64Encoding() << std::endl;
+    } else {
+        plugin->flushPluginStateToValueTree(); // FluishPlugin State helped me figure out how to access state in a thread-safe way
+        std::cout << "Showing xml state, because " << plugin->getName() << " is not an external plugin" << std::endl;
+        std::cout << plugin->state.toXmlString() << std::endl;
+    }
+}
+
+MemoryBlock getPluginState(te::Plugin* plugin) {
+    MemoryBlock mb;
+    if (!plugin) return mb;
     if (auto extPlugin = dynamic_cast<te::ExternalPlugin*>(plugin)) {
-        AudioPluginInstance*  jucePlugin = extPlugin->getAudioPluginInstance();
-        MemoryBlock mb;
+        AudioPluginInstance* jucePlugin = extPlugin->getAudioPluginInstance();
+        if (!jucePlugin) return mb;
         jucePlugin->suspendProcessing(true);
         if (extPlugin->isVST()) VSTPluginFormat::saveToFXBFile(jucePlugin, mb, false);
         else jucePlugin->getStateInformation(mb); // works for vst3 and tracktion plugins
         jucePlugin->suspendProcessing(false);
-        std::cout << "Plugin state: " << std::endl << mb.toBase64Encoding() << std::endl;
     } else {
-        plugin->flushPluginStateToValueTree(); // FluishPlugin State helped me figure out how to access state in a thread-safe way
-        std::cout << "Showing xml state, because " << plugin->getName() << " is not an external plugin" << std::endl;
-        std::cout << plugin->state.toXmlString() << std::endl;
+        plugin->flushPluginStateToValueTree();
+        MemoryOutputStream stream(mb, false);
+        plugin->state.writeToStream(stream);
+    }
+    return mb;
+}
+
+te::AutomatableParameter* getParameterByName(te::Plugin& plugin, const String& name) {
+    for (te::AutomatableParameter* param : plugin.getAutomatableParameters())
+        if (param->paramName.equalsIgnoreCase(name)) return param;
+    return nullptr;
+}
+
+AudioProcessorParameter* getProcessorParameter(te::Plugin& plugin, te::AutomatableParameter& param) {
+    auto extPlugin = dynamic_cast<te::ExternalPlugin*>(&plugin);
+    if (!extPlugin) return nullptr;
+    AudioPluginInstance* jucePlugin = extPlugin->getAudioPluginInstance();
+    if (!jucePlugin) return nullptr;
+    // ExternalPlugin takes the paramID from the processor parameter when it
+    // has one, and uses the parameter's index otherwise
+    const auto& parameters = jucePlugin->getParameters();
+    for (int i = 0; i < parameters.size(); i++) {
+        auto* p = parameters.getUnchecked(i);
+        auto* withID = dynamic_cast<AudioProcessorParameterWithID*>(p);
+        if (withID ? withID->paramID == param.paramID : String(i) == param.paramID) return p;
+    }
+    for (auto* p : parameters)
+        if (p->getName(1024) == param.paramName) return p;
+    return nullptr;
+}
+
+bool setPluginState(te::Plugin* plugin, const void* data, size_t size) {
+    if (!plugin || !data || size == 0) return false;
+    if (auto extPlugin = dynamic_cast<te::ExternalPlugin*>(plugin)) {
+        AudioPluginInstance* jucePlugin = extPlugin->getAudioPluginInstance();
+        if (!jucePlugin) return false;
+        bool ok = true;
+        jucePlugin->suspendProcessing(true);
+        if (extPlugin->isVST()) ok = VSTPluginFormat::loadFromFXBFile(jucePlugin, data, size);
+        else jucePlugin->setStateInformation(data, (int)size);
+        jucePlugin->suspendProcessing(false);
+        // Copy the new state into the edit, so it is saved with it
+        if (ok) extPlugin->flushPluginStateToValueTree();
+        return ok;
     }
+
+    ValueTree preset = ValueTree::readFromData(data, size);
+    if (!preset.hasType(te::IDs::PLUGIN) || preset[te::IDs::type] != plugin->state[te::IDs::type]) return false;
+    plugin->restorePluginStateFromValueTree(preset);
+    return true;
 }
 
 void saveTracktionPreset(te::Plugin* plugin, String name) {
@@ -401,7 +508,7 @@ void saveTracktionPreset(te::Plugin* plugin, String name) {
         .getChildFile(File::createLegalFileName(name));
 
     if (!file.hasWriteAccess()) {
-        std::cout << "Cannot write to file: does not have write access: " << file.getFullPathName() << std::endl;
+        CYBR_LOG(plugin, warn, "Cannot write to file: does not have write access: " << file.getFullPathName());
         return;
     }
     ValueTree state(te::IDs::PRESET);
@@ -412,7 +519,7 @@ void saveTracktionPreset(te::Plugin* plugin, String name) {
     state.setProperty(te::IDs::path, file.getParentDirectory().getFullPathName(), nullptr);
     state.setProperty(te::IDs::tags, "cybr", nullptr);
     state.createXml()->writeTo(file);
-    std::cout << "Save tracktion preset: " << file.getFullPathName() << std::endl;
+    CYBR_LOG(plugin, info, "Save tracktion preset: " << file.getFullPathName());
 }
 
 ValueTree loadXmlFile(File file) {
@@ -420,51 +527,118 @@ ValueTree loadXmlFile(File file) {
 
     if (file.existsAsFile()) {
         if (auto xml = XmlDocument::parse(file)) result = ValueTree::fromXml(*xml.get());
-        else std::cout << "Failed to parse xml in: " << file.getFullPathName() << std::endl;
+        else CYBR_LOG(plugin, warn, "Failed to parse xml in: " << file.getFullPathName());
     } else {
-        std::cout << "File does not exist!" << std::endl;
+        CYBR_LOG(plugin, warn, "File does not exist!");
     }
     return result;
 }
 
-void printOscMessage(const OSCMessage& message) {
-    std::cout << message.getAddressPattern().toString();
+String oscMessageToString(const OSCMessage& message) {
+    String result = message.getAddressPattern().toString();
     for (const auto& arg : message) {
-        std::cout << " - ";
+        result << " - ";
         auto type = arg.getType();
-        if (type == OSCTypes::int32) std::cout << arg.getInt32();
-        else if (type == OSCTypes::string) std::cout << arg.getString();
-        else if (type == OSCTypes::float32) std::cout << arg.getFloat32();
-        else if (type == OSCTypes::blob) std::cout << arg.getBlob().toBase64Encoding();
+        if (type == OSCTypes::int32) result << arg.getInt32();
+        else if (type == OSCTypes::string) result << arg.getString();
+        else if (type == OSCTypes::float32) result << arg.getFloat32();
+        else if (type == OSCTypes::blob) result << arg.getBlob().toBase64Encoding();
         else if (type == OSCTypes::colour) {
             OSCColour c = arg.getColour();
-            std::cout << "RGBA("<< c.red << "," << c.green << "," << c.blue << "," << c.alpha << ")";
+            result << "RGBA(" << (int)c.red << "," << (int)c.green << "," << (int)c.blue << "," << (int)c.alpha << ")";
         }
     }
-    std::cout << std::endl;
+    return result;
 };
 
-te::AudioTrack* getOrCreateAudioTrackByName(te::Edit& edit, const String name) {
+te::AudioTrack* findAudioTrackByName(te::Edit& edit, const String& name) {
     for (auto* track : te::getAudioTracks(edit)) {
         if (track->getName() == name) return track;
     }
+    return nullptr;
+}
+
+te::AudioTrack* getOrCreateAudioTrackByName(te::Edit& edit, const String name) {
+    if (auto* track = findAudioTrackByName(edit, name)) return track;
     te::TrackInsertPoint insertPoint(nullptr, te::getTopLevelTracks(edit).getLast()); // Does this work if there are no tracks?
     te::AudioTrack* track = edit.insertNewAudioTrack(insertPoint, nullptr).get();
     track->setName(name);
     return track;
 }
 
-te::MidiClip* getOrCreateMidiClipByName(te::AudioTrack& track, const String name) {
+te::MidiClip* findMidiClipByName(te::AudioTrack& track, const String& name) {
     for (auto* clip : track.getClips()) {
         if (auto midiClip = dynamic_cast<te::MidiClip*>(clip)) {
             if (midiClip->getName() == name) return midiClip;
         }
     }
+    return nullptr;
+}
+
+te::MidiClip* getOrCreateMidiClipByName(te::AudioTrack& track, const String name) {
+    if (auto* midiClip = findMidiClipByName(track, name)) return midiClip;
     te::MidiClip* clip = track.insertMIDIClip(name, {0, 4}, nullptr).get();
     return clip;
 }
 
-te::Plugin* getOrCreatePluginByName(te::AudioTrack& track, const String name, const String type) {
+NoteDiff replaceMidiNotes(te::MidiList& list, Array<NoteSpec> notes, UndoManager* um) {
+    // Compare starts in ticks, so float32 rounding in OSC does not make the
+    // same note look new.
+    auto key = [](int noteNumber, double startBeat) {
+        return ((int64)noteNumber << 48) + (int64)std::llround(startBeat * 960.0);
+    };
+    auto less = [&key](const NoteSpec& a, const NoteSpec& b) {
+        return key(a.noteNumber, a.startBeat) < key(b.noteNumber, b.startBeat);
+    };
+
+    // Sort the targets, keeping the last of any duplicates
+    std::stable_sort(notes.begin(), notes.end(), less);
+    Array<NoteSpec> targets;
+    for (auto& note : notes) {
+        if (!targets.isEmpty() && !less(targets.getLast(), note)) targets.removeLast();
+        targets.add(note);
+    }
+
+    NoteDiff diff;
+    Array<bool> matched;
+    matched.insertMultiple(0, false, targets.size());
+
+    // Copy the list of notes, because we remove from it as we go
+    Array<te::MidiNote*> existing(list.getNotes());
+    for (auto* note : existing) {
+        const NoteSpec probe{ note->getNoteNumber(), note->getStartBeat(), 0.0, 0 };
+        auto* found = std::lower_bound(targets.begin(), targets.end(), probe, less);
+        const int index = (int)(found - targets.begin());
+        if (found == targets.end() || less(probe, *found) || matched[index]) {
+            list.removeNote(*note, um);
+            diff.removed++;
+            continue;
+        }
+        matched.set(index, true);
+
+        bool changed = false;
+        if (std::abs(note->getLengthBeats() - found->lengthBeats) > 1.0 / 960.0) {
+            note->setStartAndLength(note->getStartBeat(), found->lengthBeats, um);
+            changed = true;
+        }
+        if (note->getVelocity() != found->velocity) {
+            note->setVelocity(found->velocity, um);
+            changed = true;
+        }
+        if (changed) diff.changed++;
+        else diff.unchanged++;
+    }
+
+    for (int i = 0; i < targets.size(); i++) {
+        if (matched[i]) continue;
+        const NoteSpec& t = targets.getReference(i);
+        list.addNote(t.noteNumber, t.startBeat, t.lengthBeats, t.velocity, 0, um);
+        diff.added++;
+    }
+    return diff;
+}
+
+te::Plugin* findPluginByName(te::AudioTrack& track, const String& name, const String& type) {
     for (te::Plugin* checkPlugin : track.pluginList) {
         // Internal plugins like "volume"
         // checkPlugin->getPluginType();   // "volume" - this is the "type" XML parameter
@@ -483,13 +657,18 @@ te::Plugin* getOrCreatePluginByName(te::AudioTrack& track, const String name, co
             }
         }
         if (match) {
-            std::cout << "Plugin select found existing plugin: " << checkPlugin->getName() << std::endl;
+            CYBR_LOG(plugin, info, "Plugin select found existing plugin: " << checkPlugin->getName());
             return checkPlugin;
         }
     }
+    return nullptr;
+}
+
+te::Plugin* getOrCreatePluginByName(te::AudioTrack& track, const String name, const String type) {
+    if (auto* plugin = findPluginByName(track, name, type)) return plugin;
 
     if (!track.pluginList.canInsertPlugin()) {
-        std::cout << "Selected track cannot insert plugin: " << name << std::endl;
+        CYBR_LOG(plugin, warn, "Selected track cannot insert plugin: " << name);
         return nullptr;
     }
 
@@ -504,7 +683,7 @@ te::Plugin* getOrCreatePluginByName(te::AudioTrack& track, const String name, co
         insertPoint++;
     }
     if (!found) insertPoint = -1;
-    std::cout << "Plugin insert index: " << insertPoint << std::endl;
+    CYBR_LOG(plugin, info, "Plugin insert index: " << insertPoint);
 
     for (PluginDescription desc : track.edit.engine.getPluginManager().knownPluginList.getTypes()) {
         if (desc.name.equalsIgnoreCase(name)) {
@@ -513,9 +692,8 @@ te::Plugin* getOrCreatePluginByName(te::AudioTrack& track, const String name, co
                     continue;
                 }
             }
-            std::cout
-                << "Inserting \"" << desc.name << "\" (" << desc.pluginFormatName << ") "
-                << "into track: " << track.getName() << std::endl;
+            CYBR_LOG(plugin, info, "Inserting \"" << desc.name << "\" (" << desc.pluginFormatName << ") "
+                << "into track: " << track.getName());
             te::Plugin::Ptr pluginPtr = track.edit.getPluginCache().createNewPlugin(te::ExternalPlugin::xmlTypeName, desc);
             track.pluginList.insertPlugin(pluginPtr, insertPoint, nullptr);
             return pluginPtr.get();
@@ -531,7 +709,7 @@ te::Plugin* getOrCreatePluginByName(te::AudioTrack& track, const String name, co
     }
 
     String typeName = type.isEmpty() ? "any type" : type;
-    std::cout << "Plugin not found: " << name << " (" << typeName << ") " << std::endl;
+    CYBR_LOG(plugin, warn, "Plugin not found: " << name << " (" << typeName << ") ");
     return nullptr;
 }
 
@@ -11,6 +11,7 @@
 #pragma once
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "CybrEdit.h"
+#include "CybrLog.h"
 
 namespace te = tracktion_engine;
 
@@ -34,20 +35,74 @@ void listPlugins(te::Engine& engine);
 void listProjects(te::Engine& engine);
 void listPluginParameters(te::Engine& engine, const String pluginName);
 void listPluginPresets(te::Engine& engine, const String pluginName);
-void printOscMessage(const OSCMessage& message);
+/** "/address - arg - arg" for log lines */
+String oscMessageToString(const OSCMessage& message);
 void printPreset(te::Plugin* plugin);
+/** The plugin's state as binary. For external plugins this is the VST FXB
+ chunk, or the data from getStateInformation for other formats. For tracktion
+ plugins it is the plugin's ValueTree, written with ValueTree::writeToStream. */
+MemoryBlock getPluginState(te::Plugin* plugin);
+/** Find a parameter by name, ignoring case. Returns nullptr if there is none. */
+te::AutomatableParameter* getParameterByName(te::Plugin& plugin, const String& name);
+/** The external plugin's own parameter behind an AutomatableParameter. Unlike
+ the AutomatableParameter, it may be set on the audio thread. Returns nullptr
+ for tracktion plugins, or if it cannot be found. */
+AudioProcessorParameter* getProcessorParameter(te::Plugin& plugin, te::AutomatableParameter& param);
+/** Restore state from getPluginState. The plugin must be the same kind of
+ plugin that the state came from. Returns false if the state was rejected. */
+bool setPluginState(te::Plugin* plugin, const void* data, size_t size);
 void saveTracktionPreset(te::Plugin* plugin, String name);
 ValueTree loadXmlFile(File file);
 
+/** These return nullptr instead of creating the track or clip */
+te::AudioTrack* findAudioTrackByName(te::Edit& edit, const String& name);
+te::MidiClip* findMidiClipByName(te::AudioTrack& track, const String& name);
 te::AudioTrack* getOrCreateAudioTrackByName(te::Edit& edit, const String name);
 te::MidiClip* getOrCreateMidiClipByName(te::AudioTrack& track, const String name);
+
+/** A note for replaceMidiNotes. Times are in beats. */
+struct NoteSpec {
+    int noteNumber;
+    double startBeat;
+    double lengthBeats;
+    int velocity;
+};
+
+struct NoteDiff {
+    int added = 0, removed = 0, changed = 0, unchanged = 0;
+};
+
+/** Make the list contain exactly these notes, by adding, removing and
+ changing as few notes as possible. Notes are matched by pitch and start beat.
+ If two notes have the same pitch and start, the later one is used. Notes
+ that do not change keep their ValueTree, so regenerating a pattern that is
+ mostly the same touches very little of the edit. */
+NoteDiff replaceMidiNotes(te::MidiList& list, Array<NoteSpec> notes, UndoManager* um);
 /** Add a plugin just before the VolumeAndPan plugin.
  `type` can be 'vst|vst3|tracktion' or an empty string.
  If `type` is an empty string, search all types. */
 te::Plugin* getOrCreatePluginByName(te::AudioTrack& track, const String name, const String type = {});
+/** Find a plugin the way getOrCreatePluginByName does, without creating it */
+te::Plugin* findPluginByName(te::AudioTrack& track, const String& name, const String& type = {});
 
 class CybrEdit;
 /** Create a copy of a the cybrEdit, suitable for playback and editing.
  CAUTION: The returned CybrEdit should be stored in a unique_ptr to ensure
  it will be deleted correctly. */
 CybrEdit* copyCybrEditForPlayback(CybrEdit& cybrEdit);
+
+/** Load a .tracktionedit file (or start an empty edit if it does not exist)
+ straight into a CybrEdit that is suitable for playback and editing. Unlike
+ createEdit followed by copyCybrEditForPlayback, the edit and its plugins are
+ only created once. The edit saves to `file`. */
+CybrEdit* loadCybrEditForPlayback(File file, te::Engine& engine);
+
+/** Create a copy of an edit for rendering or analysis, so that the source
+ edit can keep playing and changing. The caller owns the new edit. */
+te::Edit* copyEditForRendering(te::Edit& source);
+
+/** Create a task that renders every track of the whole edit to a 24 bit wav
+ file. If wavFile is File(), the task renders without writing anything (which
+ is useful when plugins in the edit are measuring it). Create the task on the
+ message thread. Its runJob method may be called from any one thread. */
+std::unique_ptr<te::Renderer::RenderTask> createRenderTask(te::Edit& edit, const File& wavFile, const String& description);
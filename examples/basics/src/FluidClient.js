@@ -1,15 +1,43 @@
 const dgram = require('dgram');
+const net = require('net');
 const osc = require('osc-min');
 
+/**
+ * Frame an OSC packet for a stream, as described by OSC 1.1 (SLIP, RFC 1055).
+ * @param {Buffer} buffer
+ * @returns {Buffer}
+ */
+function slipEncode(buffer) {
+  const out = [0xc0];
+  for (const b of buffer) {
+    if (b === 0xc0) out.push(0xdb, 0xdc);
+    else if (b === 0xdb) out.push(0xdb, 0xdd);
+    else out.push(b);
+  }
+  out.push(0xc0);
+  return Buffer.from(out);
+}
+
 /**
  * FluidOscSender will close instantly after all messages were sent.
  */
 module.exports = class FluidOscSender {
-  constructor(targetPort) {
+  /**
+   * @param {[number]} targetPort - Default is 9999
+   * @param {[string]} session - If set, every message is sent in a bundle that
+   *        begins with /session/select, so this client's selected edit, track,
+   *        clip and plugin cannot be changed by other clients.
+   * @param {[string]} transport - 'udp' (default) or 'tcp'. Use 'tcp' for
+   *        bundles that are too large for a UDP packet, like a long midiclip.
+   */
+  constructor(targetPort, session, transport) {
     if (typeof targetPort !== 'number') targetPort = 9999;
     this.targetPort = targetPort;
+    this.session = (typeof session === 'string') ? session : null;
     this.pendingMsgCount = 0;
-    this.client = dgram.createSocket('udp4');
+    this.tcp = transport === 'tcp';
+    if (this.tcp) this.client = net.connect(this.targetPort, '127.0.0.1');
+    else this.client = dgram.createSocket('udp4');
   }
 
   /**
@@ -33,6 +61,11 @@ module.exports = class FluidOscSender {
    */
   send(msgObject, timetag) {
     let buffer;
+    if (this.session && !(msgObject instanceof Buffer)) {
+      const select = { address: '/session/select', args: { type: 'string', value: this.session } };
+      msgObject = [select].concat(msgObject);
+    }
+
     if (msgObject instanceof Buffer)
       buffer = msgObject;
     else if (Array.isArray(msgObject))
@@ -44,10 +77,21 @@ module.exports = class FluidOscSender {
       buffer = osc.toBuffer(msgObject);
 
     this.pendingMsgCount++;
+    if (this.tcp) {
+      this.client.write(slipEncode(buffer), (err) => {
+        if (err) console.error('Error sending message:', err, msgObject);
+        this.pendingMsgCount--;
+        if (this.pendingMsgCount === 0) this.client.end();
+      });
+      return;
+    }
+
     this.client.send(buffer, this.targetPort, (err) => {
       if (err) console.error('Error sending message:', err, msgObject);
       this.pendingMsgCount--;
       if (this.pendingMsgCount === 0) this.client.close();
     });
   }
-}
\ No newline at end of file
+}
+
+module.exports.slipEncode = slipEncode;
\ No newline at end of file
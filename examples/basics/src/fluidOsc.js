@@ -90,6 +90,32 @@ const midiclip = {
       elements
     };
   },
+
+  /**
+   * Build a /midiclip/replace message. The server changes only the notes in
+   * the selected clip that differ from these, so it is much cheaper than
+   * clear() followed by every note when a pattern is regenerated.
+   *
+   * @param { {l:number, n: number, s: number, v?: number}[] } notes - the same
+   *        objects as midiclip.create. Velocity defaults to 64.
+   */
+  replace(notes) {
+    const args = [];
+    notes.forEach((note) => {
+      if (typeof note.n !== 'number' ||
+          typeof note.s !== 'number' ||
+          typeof note.l !== 'number')
+          throw new Error('Got bad note: ' + JSON.stringify(note));
+
+      args.push(
+        { type: 'integer', value: note.n },
+        { type: 'float',   value: converters.valueToWholeNotes(note.s) * 4 },
+        { type: 'float',   value: converters.valueToWholeNotes(note.l) * 4 },
+        { type: 'integer', value: (typeof note.v === 'number') ? note.v : 64 },
+      );
+    });
+    return { address: '/midiclip/replace', args };
+  },
 };
 
 
@@ -136,6 +162,58 @@ const plugin = {
     }
   },
 
+  /**
+   * Move a parameter smoothly to a value. The server updates the parameter
+   * once per audio block, so one message replaces a stream of setParam calls.
+   * @param {string} paramName
+   * @param {number} normalizedValue - target value, 0-1
+   * @param {number} seconds - duration of the ramp
+   * @param {[number]} curve - 0 is linear. Positive (up to 1) starts slowly,
+   *        negative (down to -1) starts quickly.
+   */
+  rampParam(paramName, normalizedValue, seconds, curve) {
+    if (typeof paramName !== 'string')
+      throw new Error('plugin.rampParam needs a parameterName, got: ' + paramName);
+    if (typeof normalizedValue !== 'number')
+      throw new Error('plugin.rampParam needs a value number, got ' + normalizedValue);
+    if (typeof seconds !== 'number')
+      throw new Error('plugin.rampParam needs a duration in seconds, got ' + seconds);
+    const args = [
+      { type: 'string', value: paramName },
+      { type: 'float', value: normalizedValue },
+      { type: 'float', value: seconds },
+    ];
+    if (typeof curve === 'number') args.push({ type: 'float', value: curve });
+    return { address: '/plugin/param/ramp', args };
+  },
+
+  /**
+   * Write automation points to a parameter's curve. Existing points between
+   * the first and last point are replaced.
+   * @param {string} paramName
+   * @param { {b: number, v: number, c?: number}[] } points - b is the time in
+   *        quarter notes, v is the normalized value, and c is the curve
+   *        (-1 to 1) from this point to the next. c defaults to 0.
+   */
+  automation(paramName, points) {
+    if (typeof paramName !== 'string')
+      throw new Error('plugin.automation needs a parameterName, got: ' + paramName);
+    if (!Array.isArray(points) || points.length === 0)
+      throw new Error('plugin.automation needs an array of points, got: ' + points);
+
+    const args = [{ type: 'string', value: paramName }];
+    points.forEach((p) => {
+      if (typeof p.b !== 'number' || typeof p.v !== 'number')
+        throw new Error('Got bad automation point: ' + JSON.stringify(p));
+      args.push(
+        { type: 'float', value: p.b },
+        { type: 'float', value: p.v },
+        { type: 'float', value: (typeof p.c === 'number') ? p.c : 0 },
+      );
+    });
+    return { address: '/plugin/param/automation', args };
+  },
+
   save(presetName) {
     if (typeof presetName !== 'string')
       throw new Error('plugin.save requires preset name as argument');
@@ -154,10 +232,104 @@ const plugin = {
       address: '/plugin/load',
       args: { type: 'string', value: presetName },
     };
-  }
+  },
+
+  /**
+   * Ask for the selected plugin's state. The server replies to the replyPort
+   * with /plugin/state pluginName blob. The reply is one UDP packet, so very
+   * large states (over about 64 KB) cannot be sent. For those, the server
+   * replies /plugin/state/error pluginName reason instead.
+   */
+  getState() { return { address: '/plugin/state/get' } },
+
+  /**
+   * Restore state from a /plugin/state reply to the selected plugin. The
+   * plugin must be the same kind of plugin that the state came from.
+   * @param {Buffer} state
+   */
+  setState(state) {
+    if (!Buffer.isBuffer(state))
+      throw new Error('plugin.setState needs a Buffer, got: ' + state);
+    return {
+      address: '/plugin/state/set',
+      args: { type: 'blob', value: state },
+    };
+  },
+
+  /**
+   * Send MIDI from the selected OpenFrameworksPlugin to an OSC receiver (for
+   * example, our visuals). A port of 0 stops sending.
+   * @param {string} hostname
+   * @param {number} port
+   */
+  setOscTarget(hostname, port) {
+    if (typeof hostname !== 'string')
+      throw new Error('plugin.setOscTarget needs a hostname, got: ' + hostname);
+    if (!Number.isInteger(port))
+      throw new Error('plugin.setOscTarget needs an integer port, got: ' + port);
+
+    return {
+      address: '/plugin/osc/target',
+      args: [
+        { type: 'string', value: hostname },
+        { type: 'integer', value: port },
+      ],
+    };
+  },
 };
 
 const global = {
+  /**
+   * Ask the server to send replies (like /progress and /ack) to a port.
+   * @param {number} port - A port of 0 stops replies
+   * @param {[string]} hostname - Default is 127.0.0.1
+   */
+  replyPort(port, hostname) {
+    if (!Number.isInteger(port))
+      throw new Error('global.replyPort needs an integer port, got: ' + port);
+
+    const args = [{ type: 'integer', value: port }];
+    if (typeof hostname === 'string') args.push({ type: 'string', value: hostname });
+    return { address: '/reply/port', args };
+  },
+
+  /**
+   * Ask for server statistics. They are sent to the replyPort as a bundle of
+   * /stats/queue and /stats/address messages.
+   * @param {[number]} periodMs - If set, push them every periodMs. 0 stops.
+   */
+  stats(periodMs) {
+    if (periodMs === undefined) return { address: '/stats' };
+    if (!Number.isInteger(periodMs))
+      throw new Error('global.stats needs an integer period, got: ' + periodMs);
+    return { address: '/stats/push', args: { type: 'integer', value: periodMs } };
+  },
+
+  /**
+   * Ask the server to acknowledge this bundle with /ack id handlerMicros
+   * queueDepth after it has applied all of it. Sent alone (not in a bundle),
+   * the ack means that everything sent before it has been applied.
+   * @param {number|string} id
+   */
+  seq(id) {
+    if (Number.isInteger(id)) return { address: '/seq', args: { type: 'integer', value: id } };
+    if (typeof id === 'string') return { address: '/seq', args: { type: 'string', value: id } };
+    throw new Error('global.seq needs an integer or string id, got: ' + id);
+  },
+
+  /**
+   * While the transport plays, hold changes to the edit's structure, and
+   * rebuild the playback graph once with all of them.
+   * @param {number|string} window - Milliseconds to hold changes, or 'bar' to
+   *        hold them until the next bar line. 0 rebuilds after every change.
+   */
+  rebuildWindow(window) {
+    if (window === 'bar') return { address: '/rebuild/window', args: { type: 'string', value: 'bar' } };
+    if (!Number.isInteger(window) || window < 0)
+      throw new Error('global.rebuildWindow needs milliseconds or \'bar\', got: ' + window);
+    return { address: '/rebuild/window', args: { type: 'integer', value: window } };
+  },
+
   /**
    * @param {string} filename - '.tracktionedit' or '.wav' filename
    * @param {[bool]} absolute - If true use absolute paths for audio file
@@ -174,6 +346,74 @@ const global = {
   },
 };
 
+const edit = {
+  /**
+   * Create an edit on the server (or replace one with the same name), and
+   * select it. Messages that follow apply to this edit.
+   * @param {string} name
+   * @param {[string]} filename - A .tracktionedit file to load if it exists.
+   *        '/save' with no filename saves here. Default is `${name}.tracktionedit`
+   */
+  create(name, filename) {
+    if (typeof name !== 'string')
+      throw new Error('edit.create requires an edit name, got: ' + name);
+
+    const args = [{ type: 'string', value: name }];
+    if (typeof filename === 'string') args.push({ type: 'string', value: filename });
+    return { address: '/edit/create', args };
+  },
+
+  /**
+   * Select an edit that was created with edit.create. Each edit has its own
+   * transport and selection.
+   * @param {string} name
+   */
+  select(name) {
+    if (typeof name !== 'string')
+      throw new Error('edit.select requires an edit name, got: ' + name);
+
+    return { address: '/edit/select', args: { type: 'string', value: name } };
+  },
+
+  remove(name) {
+    if (typeof name !== 'string')
+      throw new Error('edit.remove requires an edit name, got: ' + name);
+
+    return { address: '/edit/remove', args: { type: 'string', value: name } };
+  },
+
+  /**
+   * Render a copy of the selected edit to a .wav file on a background thread.
+   * @param {[string]} filename - Default is `${name}.wav`
+   */
+  render(filename) {
+    if (typeof filename !== 'string') return { address: '/edit/render' };
+    return { address: '/edit/render', args: { type: 'string', value: filename } };
+  },
+};
+
+const session = {
+  /**
+   * Messages that follow (until the end of the bundle) use the selection state
+   * of this session. Put this first in each bundle when several clients share
+   * a server.
+   * @param {string} id
+   */
+  select(id) {
+    if (typeof id !== 'string')
+      throw new Error('session.select requires a session id, got: ' + id);
+
+    return { address: '/session/select', args: { type: 'string', value: id } };
+  },
+
+  close(id) {
+    if (typeof id !== 'string')
+      throw new Error('session.close requires a session id, got: ' + id);
+
+    return { address: '/session/close', args: { type: 'string', value: id } };
+  },
+};
+
 const transport = {
   play() { return { address: '/transport/play',} },
   stop() { return { address: '/transport/stop',} },
@@ -222,5 +462,7 @@ module.exports = {
   audiotrack,
   plugin,
   global,
+  edit,
+  session,
   transport
 };
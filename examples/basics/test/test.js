@@ -137,3 +137,50 @@ describe('midiclip.create', () => {
     }])
   });
 });
+
+describe('midiclip.replace', () => {
+  it('should flatten notes into pitch, start, length and velocity', () => {
+    fluid.midiclip.replace([{ n: 60, s: 0, l: 0.25, v: 100 }, { n: 64, s: 0.5, l: 0.125 }])
+      .should.deepEqual({
+        address: '/midiclip/replace',
+        args: [
+          { type: 'integer', value: 60 },
+          { type: 'float',   value: 0 },
+          { type: 'float',   value: 1 },
+          { type: 'integer', value: 100 },
+          { type: 'integer', value: 64 },
+          { type: 'float',   value: 2 },
+          { type: 'float',   value: 0.5 },
+          { type: 'integer', value: 64 },
+        ],
+      });
+  });
+});
+
+describe('plugin.automation', () => {
+  it('should flatten points into beat, value and curve', () => {
+    fluid.plugin.automation('cutoff', [{ b: 0, v: 0.25 }, { b: 4, v: 1, c: 0.5 }])
+      .should.deepEqual({
+        address: '/plugin/param/automation',
+        args: [
+          { type: 'string', value: 'cutoff' },
+          { type: 'float', value: 0 },
+          { type: 'float', value: 0.25 },
+          { type: 'float', value: 0 },
+          { type: 'float', value: 4 },
+          { type: 'float', value: 1 },
+          { type: 'float', value: 0.5 },
+        ],
+      });
+  });
+});
+
+describe('slipEncode', () => {
+  const { slipEncode } = require('../src/FluidClient');
+  it('should wrap a packet in END bytes', () => {
+    slipEncode(Buffer.from([1, 2, 3])).should.deepEqual(Buffer.from([0xc0, 1, 2, 3, 0xc0]));
+  });
+  it('should escape END and ESC bytes', () => {
+    slipEncode(Buffer.from([0xc0, 0xdb])).should.deepEqual(Buffer.from([0xc0, 0xdb, 0xdc, 0xdb, 0xdd, 0xc0]));
+  });
+});